@@ -1,23 +1,38 @@
 package com.remotemotorcontroller.adapter
 
+import android.util.Log
 import androidx.lifecycle.ViewModel
 import androidx.lifecycle.viewModelScope
 import com.github.mikephil.charting.data.Entry
+import com.remotemotorcontroller.ble.BLEContract
 import com.remotemotorcontroller.ble.BLEManager
 import com.remotemotorcontroller.ble.BleState
+import com.remotemotorcontroller.ble.Telemetry
+import com.remotemotorcontroller.ble.TelemetrySource
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.launch
 
-class AnalyticsViewModel : ViewModel() {
+// SOURCE DEFAULTS TO THE LIVE BLE LINK -> THE HOST-SIDE PIPELINE TESTS PASS A LOOPBACK SOURCE INSTEAD
+class AnalyticsViewModel(private val source: TelemetrySource = BLEManager) : ViewModel() {
 
     companion object{
         const val DT = 1f
         var MAX_POINTS = 600
+
+        // A LIVE SEQ THIS FAR BEHIND THE SERIES CAN ONLY MEAN THE DEVICE RESTARTED (FIRMWARE HISTORY DEPTH)
+        const val RESTART_GAP = 1024
     }
     var xValue = 0f
         private set
 
+    // DEVICE SEQ THAT MAPS TO x = 0 -> SAMPLES ARE PLACED BY SEQ SO BACKFILLED GAPS LINE UP
+    private var seqOrigin: Long? = null
+
+    // LIVE STEP RESPONSE METRICS -> FED IN DEVICE SEQ ORDER, STEPS START ON EACH SENT COMMAND
+    val stepAnalyzer = StepResponseAnalyzer()
+    private var lastAnalyzedSeq = -1L
+
     val rpmEntries: MutableList<Entry> = mutableListOf()
     val angleEntries: MutableList<Entry> = mutableListOf()
 
@@ -25,30 +40,132 @@ class AnalyticsViewModel : ViewModel() {
     val updates = _updates.asSharedFlow()
     init{
         viewModelScope.launch{
-            BLEManager.state.collect{state ->
+            source.state.collect{state ->
 
+                if(state is BleState.Disconnected){
+                    stepAnalyzer.finish()?.let(::logStep)   // THE RUN'S LAST STEP HAS NO NEXT COMMAND TO CLOSE IT
+                    _updates.tryEmit(Unit)
+                }
                 if(state is BleState.Connected){
-                    if(state.telemetry != null){
-                        appendPoint(state.telemetry.rpm, state.telemetry.angle)
+                    // STREAMED SAMPLES ARRIVE THROUGH source.stream IN BATCH ORDER -> ONLY GATT TELEMETRY HERE
+                    if(state.telemetry != null && !state.streamed){
+                        appendTelemetry(state.telemetry)
                     }
                 }
             }
         }
+        viewModelScope.launch{
+            source.backfill.collect{ samples ->
+                addSamples(samples, live = false)
+            }
+        }
+        viewModelScope.launch{
+            source.stream.collect{ samples ->
+                addSamples(samples)
+            }
+        }
+        viewModelScope.launch{
+            source.commands.collect{ c ->
+                stepAnalyzer.onCommand(c.cmd == BLEContract.CMD_POSITION, c.value)?.let(::logStep)
+                _updates.tryEmit(Unit)
+            }
+        }
+    }
+
+    // PER STEP LOG FOR COMPARING TUNING RUNS
+    private fun logStep(m: StepResponseAnalyzer.StepMetrics){
+        Log.i("STEP", m.toString())
+    }
+
+    fun appendTelemetry(t: Telemetry){
+        val seq = t.seq
+        if(seq == null){    // OLD FIRMWARE WITHOUT SEQ -> ONE STEP PER SAMPLE
+            appendPoint(t.rpm, t.angle)
+            return
+        }
+
+        addSamples(listOf(t))
+    }
+
+    // SEQ BEFORE THE RECORDING OR FAR BEHIND ITS END -> FOR LIVE DATA ONLY A DEVICE RESTART DOES THAT
+    private fun isRestart(seq: Long): Boolean {
+        val origin = seqOrigin ?: return false
+        return seq < origin || (seq - origin) * DT < xValue - RESTART_GAP * DT
     }
 
     fun appendPoint(rpm: Int, angle: Int){
         rpmEntries.add(Entry(xValue, rpm.toFloat()))
         angleEntries.add(Entry(xValue, angle.toFloat()))
 
-        if(rpmEntries.size > MAX_POINTS) rpmEntries.removeAt(0)
-        if(angleEntries.size > MAX_POINTS) angleEntries.removeAt(0)
+        trim()
         xValue += DT
 
         _updates.tryEmit(Unit)  // NOTIFY THE ANALYTIC UI THAT DATA HAS CHANGED
     }
 
+    // PLACE SAMPLES BY SEQ -> GATT, L2CAP STREAM AND BACKFILL CAN OVERLAP, THE FIRST ENTRY FOR A SEQ WINS.
+    // LIVE (GATT / STREAM) SAMPLES THAT LOOK LIKE A RESTART CONTINUE THE SERIES FROM THE CURRENT END,
+    // BACKFILLED ONES ARE OLDER BY DESIGN SO THEY ARE DROPPED INSTEAD (PREVIOUS SESSION / BEFORE THE RECORDING)
+    fun addSamples(samples: List<Telemetry>, live: Boolean = true){
+        val first = samples.firstOrNull { it.seq != null }?.seq ?: return
+        if(seqOrigin == null) seqOrigin = first - (xValue / DT).toLong()
+
+        val rpmAdded = mutableListOf<Entry>()
+        val angleAdded = mutableListOf<Entry>()
+        for(t in samples){
+            val seq = t.seq ?: continue
+            if(isRestart(seq)){
+                if(!live) continue
+                seqOrigin = seq - (xValue / DT).toLong()
+                lastAnalyzedSeq = -1L
+            }
+            val origin = seqOrigin!!
+
+            // ANALYTICS NEED STRICT ORDER -> LATE (BACKFILLED / DUPLICATE) SAMPLES ONLY GO TO THE CHART
+            if(seq > lastAnalyzedSeq){
+                lastAnalyzedSeq = seq
+                t.timeMs?.let { stepAnalyzer.onSample(it, t.status, t.rpm, t.angle) }
+            }
+
+            val x = (seq - origin) * DT
+            rpmAdded.add(Entry(x, t.rpm.toFloat()))
+            angleAdded.add(Entry(x, t.angle.toFloat()))
+        }
+        if(rpmAdded.isEmpty()) return
+
+        val lastX = rpmEntries.lastOrNull()?.x
+        if(lastX == null || rpmAdded.first().x > lastX){
+            // COMMON CASE -> NEWER THAN EVERYTHING PLOTTED, APPEND
+            rpmEntries.addAll(rpmAdded)
+            angleEntries.addAll(angleAdded)
+        } else {
+            mergeSorted(rpmEntries, rpmAdded)
+            mergeSorted(angleEntries, angleAdded)
+        }
+        trim()
+        xValue = maxOf(xValue, rpmEntries.last().x + DT)
+
+        _updates.tryEmit(Unit)
+    }
+
+    // CHART NEEDS ENTRIES SORTED BY x -> KEEP THE SAME LIST INSTANCE SINCE THE DATA SETS REFERENCE IT
+    private fun mergeSorted(list: MutableList<Entry>, added: List<Entry>){
+        val merged = (list + added).distinctBy { it.x }.sortedBy { it.x }
+        list.clear()
+        list.addAll(merged)
+    }
+
+    private fun trim(){
+        while(rpmEntries.size > MAX_POINTS) rpmEntries.removeAt(0)
+        while(angleEntries.size > MAX_POINTS) angleEntries.removeAt(0)
+    }
+
     fun reset(){
         xValue = 0f
+        seqOrigin = null
+        lastAnalyzedSeq = -1L
+        stepAnalyzer.finish()?.let(::logStep)
+        stepAnalyzer.reset()
         rpmEntries.clear()
         angleEntries.clear()
         _updates.tryEmit(Unit)
@@ -58,4 +175,4 @@ class AnalyticsViewModel : ViewModel() {
         MAX_POINTS = maxPts
         _updates.tryEmit(Unit)
     }
-}
\ No newline at end of file
+}
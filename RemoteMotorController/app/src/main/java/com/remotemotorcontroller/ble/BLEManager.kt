@@ -10,6 +10,7 @@ import android.bluetooth.BluetoothGattCharacteristic
 import android.bluetooth.BluetoothGattDescriptor
 import android.bluetooth.BluetoothManager
 import android.bluetooth.BluetoothProfile
+import android.bluetooth.BluetoothSocket
 import android.bluetooth.le.BluetoothLeScanner
 import android.bluetooth.le.ScanCallback
 import android.bluetooth.le.ScanFilter
@@ -17,49 +18,68 @@ import android.bluetooth.le.ScanResult
 import android.bluetooth.le.ScanSettings
 import android.content.Context
 import android.os.Build
+import android.os.Handler
+import android.os.HandlerThread
+import android.os.Looper
 import android.os.ParcelUuid
 import android.util.Log
 import androidx.annotation.RequiresPermission
-import androidx.lifecycle.lifecycleScope
 import com.remotemotorcontroller.adapter.BleTimeDevice
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
 import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.android.asCoroutineDispatcher
 import kotlinx.coroutines.delay
 import kotlinx.coroutines.flow.MutableSharedFlow
 import kotlinx.coroutines.flow.MutableStateFlow
 import kotlinx.coroutines.flow.SharedFlow
 import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asSharedFlow
 import kotlinx.coroutines.flow.asStateFlow
 import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
+import java.io.IOException
 import java.time.Duration
 import java.time.Instant
 import java.util.UUID
 
 @SuppressLint("StaticFieldLeak")
-object BLEManager {
+object BLEManager : TelemetrySource {
 
     private val _state = MutableStateFlow<BleState>(BleState.Disconnected)
-    val state: StateFlow<BleState> = _state.asStateFlow()
+    override val state: StateFlow<BleState> = _state.asStateFlow()
+
+    // SAMPLES MISSED DURING A DROPOUT, PULLED FROM THE FIRMWARE'S HISTORY RING AFTER RECONNECT
+    private val _backfill = MutableSharedFlow<List<Telemetry>>(extraBufferCapacity = 64)
+    override val backfill: SharedFlow<List<Telemetry>> = _backfill.asSharedFlow()
+
+    // DISCRETE COMMANDS AS THEY ARE QUEUED -> STEP TRIGGERS FOR THE ANALYTICS
+    private val _commands = MutableSharedFlow<MotorCommand>(extraBufferCapacity = 16)
+    override val commands: SharedFlow<MotorCommand> = _commands.asSharedFlow()
+
+    // EVERY CONTROL TICK, BATCHED OVER THE L2CAP COC CHANNEL (EMPTY IF THE FIRMWARE HAS NO STREAM)
+    private val _stream = MutableSharedFlow<List<Telemetry>>(extraBufferCapacity = 64)
+    override val stream: SharedFlow<List<Telemetry>> = _stream.asSharedFlow()
 
     private lateinit var appCtx: Context
     private lateinit var bluetoothManager: BluetoothManager
     private var bluetoothAdapter: BluetoothAdapter? = null
     private var scanner: BluetoothLeScanner? = null
     private val scannedDevices = mutableListOf<BleTimeDevice>()
-    private var isScanning = false
+    @Volatile private var isScanning = false   // WRITTEN ON THE BLE THREAD, READ BY THE UI
     fun isScanning(): Boolean = isScanning
 
     // BLE GATT CLIENT -> ALLOWS FOR CONNECTION TO BLE GATT SERVERS
     // INFORMATION REGARDING DISCOVERING SERVICES, READING, AND WRITING CHARACTERISTICS
     private var bluetoothGatt: BluetoothGatt? = null
-    private var connectedDevice: BluetoothDevice? = null
+    @Volatile private var connectedDevice: BluetoothDevice? = null
     fun getConnectedDevice(): BluetoothDevice? = connectedDevice
     private var userInitDisconnect: Boolean = false
 
     private var requestQueue: BleRequestQueue? = null
+    private val commander = MotorCommander({ requestQueue }) { _commands.tryEmit(it) }
+    private var gattTransport: GattTransport? = null
 
     // CONFIGURED WITH SETTINGS TO LOCAL VARIABLES
     private var autoReconnectEnabled = true
@@ -71,38 +91,75 @@ object BLEManager {
     private var scanMode: Int = ScanSettings.SCAN_MODE_LOW_LATENCY
     private var cleanupDurationMs: Long = 5_000L
 
-    // LISTENERS
+    // LISTENERS -> SET FROM THE UI, INVOKED ON THE BLE THREAD
     // FUNCTION TO CALL WHEN A DEVICE IS FOUND
-    private var onDeviceFound: ((BleTimeDevice) -> Unit)? = null
+    @Volatile private var onDeviceFound: ((BleTimeDevice) -> Unit)? = null
 
     // FUNCTION TO CALL WHEN A DEVICE IS TO BE REMOVED
-    private var onDeviceRemoved: ((BleTimeDevice) -> Unit)? = null
+    @Volatile private var onDeviceRemoved: ((BleTimeDevice) -> Unit)? = null
 
 
     // GATT CHARACTERISTICS
     private var charCmd: BluetoothGattCharacteristic? = null
     private var charTelem: BluetoothGattCharacteristic? = null
     private var charHeartbeat: BluetoothGattCharacteristic? = null
+    private var charHistory: BluetoothGattCharacteristic? = null
+    private var charSetpoint: BluetoothGattCharacteristic? = null
+
+    // BACKFILL TRACKING
+    private val backfillTracker = BackfillTracker()
+
+    // DEDICATED BLE THREAD -> GATT CALLBACKS, HEARTBEAT, SCAN HANDLING AND RECONNECT ALL RUN HERE
+    // SO A CHART REDRAW OR FRAGMENT TRANSITION ON THE MAIN THREAD CAN'T DELAY THE HEARTBEAT (2s FIRMWARE WATCHDOG)
+    // IT IS ALSO THE ONLY THREAD THAT TOUCHES THE GATT, SCAN, JOB AND CHARACTERISTIC FIELDS -> EVERY PUBLIC
+    // ENTRY POINT HOPS ONTO IT THROUGH onBleThread()
+    private val bleThread = HandlerThread("BleThread").apply { start() }
+    private val bleHandler = Handler(bleThread.looper)
 
     // JOBS
     // COROUTINE SCOPE TO MANAGE BACKGROUND JOB's LIFECYCLE
     //COROUTINE is A FUNCTION THAT CAN PAUSE AND RESUME ITS EXECUTION WITHOUT BLOCKING THE THREAD
-    private val coroutineScope = CoroutineScope(Dispatchers.Main + SupervisorJob())
+    private val bleDispatcher = bleHandler.asCoroutineDispatcher("BleDispatcher")
+    private val coroutineScope = CoroutineScope(bleDispatcher + SupervisorJob())
     private var cleanupJob: Job? = null // PERIODICALLY CLEAN UP THE STALE DEVICES FOR SCANNING
     private var reconnectJob: Job? = null
 
     private var heartbeatJob: Job? = null
 
+    @Volatile private var streamSocket: BluetoothSocket? = null
+    private var streamJob: Job? = null
+
+    // TELEOPERATION -> LOOP SENDS WHATEVER THE LATEST TARGET IS AT A FIXED RATE
+    private var teleopJob: Job? = null
+    private var teleopMode: Byte = BLEContract.CMD_SPEED
+    private var teleopTarget: Int = 0
+    private var teleopSeq = 0
+    private val _teleopActive = MutableStateFlow(false)
+    val teleopActive: StateFlow<Boolean> = _teleopActive.asStateFlow()
+
     fun init(context: Context){
         appCtx = context.applicationContext
         bluetoothManager = appCtx.getSystemService(Context.BLUETOOTH_SERVICE) as BluetoothManager
         bluetoothAdapter = bluetoothManager.adapter
         scanner = bluetoothAdapter?.bluetoothLeScanner
 
-        requestQueue = BleRequestQueue(coroutineScope) { bluetoothGatt }
+        requestQueue = BleRequestQueue(coroutineScope, bleDispatcher, logError = { Log.e("BLE", it) }) { transport() }
         requestQueue?.start()
     }
 
+    // RUN INLINE WHEN ALREADY ON THE BLE THREAD (CALLBACKS, JOBS), OTHERWISE POST IN CALL ORDER
+    private fun onBleThread(block: () -> Unit){
+        if(Looper.myLooper() == bleThread.looper) block() else bleHandler.post(block)
+    }
+
+    // QUEUE WRITES THROUGH THE CURRENT GATT -> REBUILT ONLY WHEN THE GATT INSTANCE CHANGES.
+    // CALLED BY THE QUEUE ON bleDispatcher, SO IT NEVER SEES A GATT THAT onLinkLost / connectGatt IS REPLACING
+    private fun transport(): MotorTransport? {
+        val gatt = bluetoothGatt ?: return null
+        return gattTransport?.takeIf { it.gatt === gatt }
+            ?: GattTransport(gatt).also { gattTransport = it }
+    }
+
     // CALLBACK FUNCTIONS
     // CALLBACK FUNCTION FOR GATT
     private val gattCallback = object : BluetoothGattCallback() {
@@ -110,8 +167,9 @@ object BLEManager {
         @SuppressLint("MissingPermission")
         override fun onConnectionStateChange(gatt: BluetoothGatt, status: Int, newState: Int) {
             if(status != BluetoothGatt.GATT_SUCCESS){
+                // LINK LOSS USUALLY ARRIVES THIS WAY (8 = SUPERVISION TIMEOUT) -> SAME AS A DROPOUT, NOT A USER DISCONNECT
                 Log.e("BLE", "GATT ERROR $status")
-                disconnect()
+                onLinkLost(gatt)
                 return
             }
 
@@ -122,18 +180,7 @@ object BLEManager {
                 gatt.discoverServices()
             }
             else if(newState == BluetoothProfile.STATE_DISCONNECTED){
-                _state.value = BleState.Disconnected
-
-                gatt.close()
-                bluetoothGatt = null
-                requestQueue?.clear()
-                heartbeatJob?.cancel()
-
-                // AUTO-RECONNECT IFF NOT-USER INIT, ENABLED, AND TARGET ID
-                if(!userInitDisconnect && autoReconnectEnabled && arDeviceId?.size == 6){
-                    triggerAutoReconnect()
-                }
-                userInitDisconnect = false
+                onLinkLost(gatt)
             }
         }
         @SuppressLint("MissingPermission")
@@ -147,10 +194,18 @@ object BLEManager {
                 charCmd = serv.getCharacteristic(BLEContract.CHAR_CMD)
                 charTelem = serv.getCharacteristic(BLEContract.CHAR_TELEM)
                 charHeartbeat = serv.getCharacteristic(BLEContract.CHAR_HEARTBEAT)
-
-                charTelem?.let{ enableNotifications(gatt, it)}
+                charHistory = serv.getCharacteristic(BLEContract.CHAR_HISTORY)
+                charSetpoint = serv.getCharacteristic(BLEContract.CHAR_SETPOINT)
+
+                // MTU FIRST SO BACKFILL PACKS MANY SAMPLES PER NOTIFICATION, THEN THE CCCs FROM onMtuChanged
+                // (HISTORY CCC FROM onDescriptorWrite) -> ONLY ONE GATT OPERATION AT A TIME
+                if(!gatt.requestMtu(BLEContract.REQUEST_MTU)){
+                    Log.w("BLE", "MTU REQUEST FAILED, STAYING AT ${BLEContract.ATT_MTU_DEFAULT}")
+                    charTelem?.let{ enableNotifications(gatt, it)}
+                }
 
                 startHeartbeatLoop()
+                openStream(gatt.device)
 
                 _state.value = BleState.Connected(gatt.device.name)
             }else{
@@ -158,18 +213,47 @@ object BLEManager {
             }
         }
 
+        @SuppressLint("MissingPermission")
+        override fun onMtuChanged(gatt: BluetoothGatt, mtu: Int, status: Int) {
+            // A REJECTED REQUEST LEAVES THE DEFAULT MTU -> SLOWER BACKFILL, SAME DATA
+            Log.i("BLE", "ATT MTU $mtu (status $status)")
+            charTelem?.let{ enableNotifications(gatt, it)}
+        }
+
         @SuppressLint("MissingPermission")
         override fun onCharacteristicChanged(
             gatt: BluetoothGatt,
             characteristic: BluetoothGattCharacteristic,
             value: ByteArray
         ) {
+            if(characteristic.uuid == BLEContract.CHAR_HISTORY){
+                handleHistory(value)
+                return
+            }
+
             val telemetryData = Telemetry.fromBytes(value)
+            telemetryData?.seq?.let { backfillTracker.onLiveSample(it) }
 
             val currentState = _state.value
             if(currentState is BleState.Connected && telemetryData != null){
                 // UPDATE ONLY THE TELEMETRY OF THE STATE
-                _state.value = currentState.copy(telemetry = telemetryData)
+                _state.value = currentState.copy(telemetry = telemetryData, streamed = false)
+            }
+        }
+
+        @SuppressLint("MissingPermission")
+        override fun onDescriptorWrite(
+            gatt: BluetoothGatt,
+            descriptor: BluetoothGattDescriptor,
+            status: Int
+        ) {
+            if(status != BluetoothGatt.GATT_SUCCESS){
+                Log.e("BLE", "CCCD WRITE FAILED for ${descriptor.characteristic.uuid} ($status)")
+                return
+            }
+            when(descriptor.characteristic.uuid){
+                BLEContract.CHAR_TELEM -> charHistory?.let { enableNotifications(gatt, it) }
+                BLEContract.CHAR_HISTORY -> requestBackfill()
             }
         }
 
@@ -237,76 +321,173 @@ object BLEManager {
         }
     }
 
-    // --- COMMANDS ---
-    private fun createPayload(cmd: Byte, value: Int): ByteArray {
-        return byteArrayOf(
-            cmd,
-            (value and 0xFF).toByte(),
-            ((value shr 8) and 0xFF).toByte(),
-            ((value shr 16) and 0xFF).toByte(),
-            ((value shr 24) and 0xFF).toByte()
-        )
+    // --- L2CAP STREAM ---
+    // OPTIONAL HIGH RATE PATH -> IF THE CHANNEL CAN'T BE OPENED, GATT NOTIFICATIONS REMAIN THE TELEMETRY SOURCE
+    @SuppressLint("MissingPermission")
+    private fun openStream(device: BluetoothDevice){
+        closeStream()
+        // BLOCKING SOCKET CALLS -> KEEP THEM OFF THE BLE THREAD
+        streamJob = coroutineScope.launch(Dispatchers.IO) {
+            val socket = try {
+                device.createInsecureL2capChannel(BLEContract.STREAM_PSM).also { it.connect() }
+            } catch (e: IOException) {
+                Log.w("BLE", "L2CAP STREAM UNAVAILABLE, USING GATT TELEMETRY (${e.message})")
+                return@launch
+            }
+            streamSocket = socket
+            Log.i("BLE", "L2CAP STREAM OPEN (max rx ${socket.maxReceivePacketSize})")
+
+            // ONE read() RETURNS ONE SDU
+            val buf = ByteArray(maxOf(socket.maxReceivePacketSize, Telemetry.SIZE + 2))
+            try {
+                val input = socket.inputStream
+                while(isActive){
+                    val n = input.read(buf)
+                    if(n < 0) break
+                    handleStreamSdu(buf, n)
+                }
+            } catch (e: IOException) {
+                Log.i("BLE", "L2CAP STREAM CLOSED (${e.message})")
+            } finally {
+                runCatching { socket.close() }
+            }
+        }
     }
 
-    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
-    fun setSpeed(rpm: Int){
-        val ch = charCmd ?: return
-        val payload = createPayload(BLEContract.CMD_SPEED, rpm)
+    private fun closeStream(){
+        // CLOSING THE SOCKET UNBLOCKS THE PENDING read()
+        runCatching { streamSocket?.close() }
+        streamSocket = null
+        streamJob?.cancel()
+        streamJob = null
+    }
 
-        requestQueue?.enqueueWrite(
-            characteristic = ch,
-            data = payload,
-            writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT,
-            priority = BleRequestQueue.PRIORITY_LOW
+    // [COUNT (2 BYTES)] [COUNT x TELEMETRY (17 BYTES)]
+    private fun handleStreamSdu(buf: ByteArray, len: Int){
+        if(len < 2) return
+        val count = minOf(
+            (buf[0].toInt() and 0xFF) or ((buf[1].toInt() and 0xFF) shl 8),
+            (len - 2) / Telemetry.SIZE
         )
+        if(count == 0) return
+
+        val samples = Telemetry.listFromBytes(buf, 2, count)
+        _stream.tryEmit(samples)
+
+        // THE FIRMWARE PAUSES GATT TELEMETRY WHILE THE STREAM IS OPEN -> THE NEWEST SAMPLE ALSO FEEDS BACKFILL
+        // TRACKING AND THE LIVE READOUT, ON THE BLE THREAD THAT OWNS BOTH
+        val latest = samples.lastOrNull() ?: return
+        onBleThread {
+            latest.seq?.let { backfillTracker.onLiveSample(it) }
+            val currentState = _state.value
+            if(currentState is BleState.Connected){
+                _state.value = currentState.copy(telemetry = latest, streamed = true)
+            }
+        }
     }
 
-    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
-    fun setPosition(pos: Int){
-        val ch = charCmd ?: return
-        val payload = createPayload(BLEContract.CMD_POSITION, pos)
+    // --- BACKFILL ---
+    // ASK THE FIRMWARE FOR EVERY SAMPLE FROM THE START OF THE LAST GAP
+    private fun requestBackfill(){
+        val ch = charHistory ?: return
+        val queue = requestQueue ?: return
+        backfillTracker.requestBackfill(queue, ch.uuid)?.let {
+            Log.i("BLE", "REQUESTING BACKFILL FROM SEQ $it")
+        }
+    }
 
-        requestQueue?.enqueueWrite(
-            characteristic = ch,
-            data = payload,
-            writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT,
-            priority = BleRequestQueue.PRIORITY_LOW
-        )
+    // [COUNT (1 BYTE)] [COUNT x TELEMETRY (17 BYTES)] -> COUNT == 0 MEANS THE BACKFILL IS DONE
+    private fun handleHistory(value: ByteArray){
+        if(value.isEmpty()) return
+        val count = value[0].toInt() and 0xFF
+        if(count == 0){
+            Log.i("BLE", "BACKFILL COMPLETE")
+            return
+        }
+
+        _backfill.tryEmit(Telemetry.listFromBytes(value, 1, count))
     }
 
-    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
-    fun calibrate(){
-        val ch = charCmd ?: return
-        val payload = createPayload(BLEContract.CMD_CALIBRATE, 0)
+    // --- COMMANDS ---
+    // ENCODING, PRIORITIES AND STEP TRIGGERS LIVE IN MotorCommander -> ONLY SENT ONCE THE SERVICE WAS DISCOVERED
+    fun setSpeed(rpm: Int) = onBleThread {
+        if(charCmd != null) commander.setSpeed(rpm)
+    }
 
-        requestQueue?.enqueueWrite(
-            characteristic = ch,
-            data = payload,
-            writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT,
-            priority = BleRequestQueue.PRIORITY_LOW
-        )
+    fun setPosition(pos: Int) = onBleThread {
+        if(charCmd != null) commander.setPosition(pos)
     }
 
-    // CRITICAL PRIORITY, DEFAULT (ACK) - SAFETY CRITICAL (MUST HAPPEN NOW AND BE CONFIRMED)
-    fun shutdown(){
-        val ch = charCmd ?: return
-        val payload = createPayload(BLEContract.CMD_SHUTDOWN, 0)
+    fun calibrate() = onBleThread {
+        if(charCmd != null) commander.calibrate()
+    }
 
-        requestQueue?.enqueueWrite(
-            characteristic = ch,
+    fun shutdown() = onBleThread {
+        // A SETPOINT SENT AFTER THE SHUTDOWN WOULD START THE FIRMWARE'S STREAM AGAIN
+        stopTeleop()
+        if(charCmd != null) commander.shutdown()
+    }
+
+    // --- TELEOPERATION ---
+    // START (OR RETARGET) THE 50 Hz SETPOINT STREAM -> mode IS CMD_SPEED OR CMD_POSITION
+    fun startTeleop(mode: Byte, value: Int) = onBleThread {
+        teleopMode = mode
+        teleopTarget = value
+        if(teleopJob?.isActive == true) return@onBleThread
+
+        teleopJob = coroutineScope.launch {
+            while(isActive){
+                sendSetpoint(teleopMode, teleopTarget)
+                delay(BLEContract.SETPOINT_PERIOD_MS)
+            }
+        }
+        _teleopActive.value = true
+    }
+
+    fun setTeleopTarget(value: Int) = onBleThread {
+        teleopTarget = value
+    }
+
+    // STOPS STREAMING ONLY -> THE FIRMWARE DECELERATES ON ITS OWN ONCE THE STREAM STALLS.
+    // SETPOINTS STILL QUEUED ARE DROPPED SO NOTHING FROM THIS STREAM IS SENT AFTER IT ENDS
+    fun stopTeleop() = onBleThread {
+        teleopJob?.cancel()
+        teleopJob = null
+        requestQueue?.removeWrites(BLEContract.CHAR_SETPOINT)
+        _teleopActive.value = false
+    }
+
+    fun isTeleopActive(): Boolean = _teleopActive.value
+
+    // STREAM PRIORITY, NO RESPONSE, LATEST-WINS - A SLOW LINK SKIPS SETPOINTS INSTEAD OF QUEUEING THEM
+    private fun sendSetpoint(mode: Byte, value: Int){
+        val ch = charSetpoint ?: return
+        teleopSeq = (teleopSeq + 1) and 0xFFFF
+        val payload = byteArrayOf(
+            mode,
+            (teleopSeq and 0xFF).toByte(),
+            ((teleopSeq shr 8) and 0xFF).toByte(),
+            (value and 0xFF).toByte(),
+            ((value shr 8) and 0xFF).toByte(),
+            ((value shr 16) and 0xFF).toByte(),
+            ((value shr 24) and 0xFF).toByte()
+        )
+
+        requestQueue?.replaceWrite(
+            charUuid = ch.uuid,
             data = payload,
-            writeType = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT,
-            priority = BleRequestQueue.PRIORITY_CRITICAL
+            writeType = BluetoothGattCharacteristic.WRITE_TYPE_NO_RESPONSE,
+            priority = BleRequestQueue.PRIORITY_STREAM
         )
     }
 
     // HIGH PRIORITY (SOLVES STARVATION PROBLEM), NO RESPONSE - MAINTAINS THE CONNECTION
-    fun sendHeartbeat(heartBeatVal: Int){
-        val ch = charHeartbeat ?: return
+    fun sendHeartbeat(heartBeatVal: Int) = onBleThread {
+        val ch = charHeartbeat ?: return@onBleThread
         val payload = byteArrayOf(heartBeatVal.toByte())
 
         requestQueue?.enqueueWrite(
-            characteristic = ch,
+            charUuid = ch.uuid,
             data = payload,
             writeType = BluetoothGattCharacteristic.WRITE_TYPE_NO_RESPONSE,
             priority = BleRequestQueue.PRIORITY_HIGH
@@ -315,8 +496,8 @@ object BLEManager {
 
     // --- SCANNING & CONNECTION ---
     @RequiresPermission(Manifest.permission.BLUETOOTH_SCAN)
-    fun startScan() {
-        if(isScanning || scanner == null || bluetoothAdapter?.isEnabled != true) return
+    fun startScan() = onBleThread {
+        if(isScanning || scanner == null || bluetoothAdapter?.isEnabled != true) return@onBleThread
 
         // DON'T START MULTIPLE JOBS -> ONLY ONE
         if(cleanupJob?.isActive != true) cleanupJob = startCleanupJob(cleanupDurationMs)
@@ -341,8 +522,8 @@ object BLEManager {
     }
 
     @SuppressLint("MissingPermission")
-    fun stopScan() {
-        if(!isScanning) return
+    fun stopScan() = onBleThread {
+        if(!isScanning) return@onBleThread
         scanner?.stopScan(leScanCallback)
 
         // CANCEL THE JOBS TO STOP THE INFINITE LOOP
@@ -356,24 +537,64 @@ object BLEManager {
         }
     }
 
-    @SuppressLint("MissingPermission")
+    // USER-INITIATED -> THE ONLY PLACE THE FOREGROUND SERVICE IS STARTED, WHILE THE UI IS VISIBLE.
+    // AUTO-RECONNECT GOES STRAIGHT TO connectGatt() AND RELIES ON THE SERVICE STILL RUNNING FROM HERE
     fun connect(device: BleTimeDevice){
+        // KEEP THE LINK ALIVE WHEN BACKGROUNDED / SCREEN OFF
+        BleService.start(appCtx)
+        onBleThread { connectGatt(device) }
+    }
+
+    @SuppressLint("MissingPermission")
+    private fun connectGatt(device: BleTimeDevice){
         stopScan()
         arDeviceId = device.devId
         bluetoothGatt?.close() // CLOSE ANY PREVIOUS CONNECTIONS
         connectedDevice = device.bDevice
-        bluetoothGatt = device.bDevice.connectGatt(appCtx, false, gattCallback)
+        userInitDisconnect = false  // NEW SESSION -> A CLOSED GATT NEVER REPORTS BACK TO CLEAR IT
+
+        // DELIVER GATT CALLBACKS ON THE BLE THREAD INSTEAD OF A BINDER THREAD
+        bluetoothGatt = device.bDevice.connectGatt(appCtx, false, gattCallback,
+            BluetoothDevice.TRANSPORT_LE, BluetoothDevice.PHY_LE_1M_MASK, bleHandler)
     }
 
     @SuppressLint("MissingPermission")
-    fun disconnect(){
+    fun disconnect() = onBleThread {
         requestQueue?.clear()
+        stopTeleop()
+        closeStream()
 
         bluetoothGatt?.disconnect()
         bluetoothGatt?.close()
         _state.value = BleState.Disconnected
         connectedDevice = null
         userInitDisconnect = true
+        backfillTracker.onUserDisconnect()
+
+        BleService.stop(appCtx)
+    }
+
+    // LINK WENT AWAY WITHOUT disconnect() (ERROR STATUS OR A CLEAN DISCONNECT FROM THE PEER)
+    // -> TEAR DOWN THE GATT BUT KEEP THE RESUME SEQ, AND LEAVE userInitDisconnect AS IT IS SO AUTO-RECONNECT RUNS
+    @SuppressLint("MissingPermission")
+    private fun onLinkLost(gatt: BluetoothGatt){
+        gatt.close()
+        if(bluetoothGatt !== gatt) return   // STALE CALLBACK FROM A GATT ALREADY REPLACED BY connectGatt()
+
+        _state.value = BleState.Disconnected
+        bluetoothGatt = null
+        requestQueue?.clear()
+        heartbeatJob?.cancel()
+        stopTeleop()
+        closeStream()
+
+        // REMEMBER WHERE THE GAP STARTS -> LIVE SAMPLES AFTER RECONNECT WILL MOVE THE LAST SEQ
+        backfillTracker.onLinkLost()
+
+        // AUTO-RECONNECT IFF NOT-USER INIT, ENABLED, AND TARGET ID
+        if(!userInitDisconnect && autoReconnectEnabled && arDeviceId?.size == 6){
+            triggerAutoReconnect()
+        }
     }
 
 
@@ -407,6 +628,22 @@ object BLEManager {
         onTimeout: () -> Unit
     ){
         require(lastDevId48.size == 6){ "deviceId64 must be 6 Bytes (LE)."}
+        onBleThread {
+            startReconnectScan(lastDevId48, companyId, serviceUUID, timeoutMs, retryInterval,
+                scanSettings, onTimeout)
+        }
+    }
+
+    @SuppressLint("MissingPermission")
+    private fun startReconnectScan(
+        lastDevId48: ByteArray,
+        companyId: Int,
+        serviceUUID: UUID,
+        timeoutMs: Long,
+        retryInterval: Long,
+        scanSettings: ScanSettings,
+        onTimeout: () -> Unit
+    ){
         if(isScanning()){
             stopScan()
         }
@@ -431,13 +668,14 @@ object BLEManager {
                 if(hit != null){
                     Log.i("BLE", "RECONNECTION SUCCESS, HIT DEVICE")
                     stopScan()
-                    connect(hit)
+                    connectGatt(hit)
                     return@launch
                 }
                 delay(retryInterval)
             }
             // TIMEOUT
             stopScan()
+            BleService.stop(appCtx)
             onTimeout()
         }
     }
@@ -505,7 +743,7 @@ object BLEManager {
         scanMode: Int,
         cleanupDurationMs: Long,
         filterScanDevice: Boolean
-    ){
+    ) = onBleThread {
         this.autoReconnectEnabled = autoReconnectEnabled
         this.arCompanyId = companyId
         this.arDeviceId = deviceId
@@ -11,16 +11,11 @@ class BleMotorSession(
         BLEContract.CHAR_HEARTBEAT)
 
     fun sendCommand(cmd: Byte, value: Int){
-        val payload = byteArrayOf(cmd,
-            (value and 0xFF).toByte(),
-            ((value shr 8) and 0xFF).toByte(),
-            ((value shr 16) and 0xFF).toByte(),
-            ((value shr 24) and 0xFF).toByte()
-        )
-        charCmd?.let { requestQueue.enqueueWrite(it, payload) }
+        val payload = BLEContract.commandPayload(cmd, value)
+        charCmd?.let { requestQueue.enqueueWrite(it.uuid, payload) }
     }
 
     fun sendHeartBeat(count: Byte){
-        charHeartbeat?.let{ requestQueue.enqueueWrite(it, byteArrayOf(count)) }
+        charHeartbeat?.let{ requestQueue.enqueueWrite(it.uuid, byteArrayOf(count)) }
     }
 }
\ No newline at end of file
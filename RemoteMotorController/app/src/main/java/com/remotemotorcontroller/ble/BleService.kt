@@ -0,0 +1,123 @@
+package com.remotemotorcontroller.ble
+
+import android.annotation.SuppressLint
+import android.app.ForegroundServiceStartNotAllowedException
+import android.app.Notification
+import android.app.NotificationChannel
+import android.app.NotificationManager
+import android.app.PendingIntent
+import android.app.Service
+import android.content.Context
+import android.content.Intent
+import android.content.pm.ServiceInfo
+import android.os.IBinder
+import android.os.PowerManager
+import android.util.Log
+import androidx.core.app.NotificationCompat
+import com.remotemotorcontroller.R
+import com.remotemotorcontroller.ui.ShellActivity
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.Job
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.flow.distinctUntilChanged
+import kotlinx.coroutines.flow.map
+import kotlinx.coroutines.launch
+
+// FOREGROUND SERVICE THAT KEEPS THE BLE LINK (HEARTBEAT + TELEMETRY) ALIVE WHILE THE APP IS
+// BACKGROUNDED OR THE SCREEN IS OFF. THE BLE WORK ITSELF RUNS ON BLEManager's OWN HANDLER THREAD
+class BleService : Service() {
+
+    companion object {
+        private const val CHANNEL_ID = "ble_link"
+        private const val NOTIFICATION_ID = 1
+        private const val WAKE_LOCK_TAG = "RemoteMotorController:BleLink"
+
+        // ONLY CALLED FROM A USER ACTION -> ANDROID 12+ REJECTS FOREGROUND STARTS FROM THE BACKGROUND.
+        // IF IT IS REJECTED ANYWAY THE LINK STILL WORKS, IT JUST ISN'T PROTECTED WHILE BACKGROUNDED
+        fun start(context: Context){
+            try {
+                context.startForegroundService(Intent(context, BleService::class.java))
+            } catch (e: ForegroundServiceStartNotAllowedException) {
+                Log.w("BLE", "FOREGROUND SERVICE NOT ALLOWED (${e.message})")
+            }
+        }
+
+        fun stop(context: Context){
+            context.stopService(Intent(context, BleService::class.java))
+        }
+    }
+
+    // ONLY USED FOR THE NOTIFICATION -> NO BLE WORK HAPPENS IN THIS SCOPE
+    private val serviceScope = CoroutineScope(Dispatchers.Main + SupervisorJob())
+    private var stateJob: Job? = null
+
+    // KEEP THE CPU AWAKE SO THE HEARTBEAT LOOP IS NOT DEFERRED WITH THE SCREEN OFF
+    private var wakeLock: PowerManager.WakeLock? = null
+
+    override fun onCreate() {
+        super.onCreate()
+        createChannel()
+    }
+
+    @SuppressLint("WakelockTimeout")
+    override fun onStartCommand(intent: Intent?, flags: Int, startId: Int): Int {
+        startForeground(NOTIFICATION_ID, buildNotification(BLEManager.state.value),
+            ServiceInfo.FOREGROUND_SERVICE_TYPE_CONNECTED_DEVICE)
+
+        if(wakeLock == null){
+            val pm = getSystemService(Context.POWER_SERVICE) as PowerManager
+            wakeLock = pm.newWakeLock(PowerManager.PARTIAL_WAKE_LOCK, WAKE_LOCK_TAG).apply { acquire() }
+        }
+
+        if(stateJob?.isActive != true){
+            stateJob = serviceScope.launch {
+                // ONLY THE CONNECTION PHASE -> TELEMETRY RATE UPDATES WOULD BE THROTTLED BY THE SYSTEM ANYWAY
+                BLEManager.state.map { statusText(it) }.distinctUntilChanged().collect {
+                    val nm = getSystemService(NotificationManager::class.java)
+                    nm.notify(NOTIFICATION_ID, buildNotification(BLEManager.state.value))
+                }
+            }
+        }
+        return START_NOT_STICKY
+    }
+
+    // NOT BOUND -> THE UI COLLECTS BLEManager.state, WHICH IS SAFE FROM ANY THREAD
+    override fun onBind(intent: Intent?): IBinder? = null
+
+    override fun onDestroy() {
+        serviceScope.cancel()
+        wakeLock?.let { if(it.isHeld) it.release() }
+        wakeLock = null
+        super.onDestroy()
+    }
+
+    private fun createChannel(){
+        val channel = NotificationChannel(CHANNEL_ID, getString(R.string.ble_channel_name),
+            NotificationManager.IMPORTANCE_LOW)
+        getSystemService(NotificationManager::class.java).createNotificationChannel(channel)
+    }
+
+    private fun statusText(state: BleState): String = when(state){
+        is BleState.Connected -> "${state.name ?: "Unknown"} • ${getString(R.string.status_connected)}"
+        is BleState.Connecting -> getString(R.string.status_connecting)
+        is BleState.Scanning -> getString(R.string.status_scanning)
+        is BleState.Disconnected -> getString(R.string.msg_not_connected)
+    }
+
+    private fun buildNotification(state: BleState): Notification {
+        val openApp = PendingIntent.getActivity(this, 0,
+            Intent(this, ShellActivity::class.java).addFlags(Intent.FLAG_ACTIVITY_SINGLE_TOP),
+            PendingIntent.FLAG_IMMUTABLE)
+
+        return NotificationCompat.Builder(this, CHANNEL_ID)
+            .setSmallIcon(R.drawable.ic_bluetooth)
+            .setContentTitle(getString(R.string.app_name))
+            .setContentText(statusText(state))
+            .setContentIntent(openApp)
+            .setOngoing(true)
+            .setOnlyAlertOnce(true)
+            .build()
+    }
+}
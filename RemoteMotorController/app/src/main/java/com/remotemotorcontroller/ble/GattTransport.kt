@@ -0,0 +1,24 @@
+package com.remotemotorcontroller.ble
+
+import android.annotation.SuppressLint
+import android.bluetooth.BluetoothGatt
+import android.bluetooth.BluetoothStatusCodes
+import android.os.Build
+import java.util.UUID
+
+class GattTransport(val gatt: BluetoothGatt) : MotorTransport {
+
+    @SuppressLint("MissingPermission")
+    override fun write(charUuid: UUID, payload: ByteArray, writeType: Int): Boolean {
+        val ch = gatt.getService(BLEContract.SERVICE_MOTOR)?.getCharacteristic(charUuid) ?: return false
+
+        return if(Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU){
+            val result = gatt.writeCharacteristic(ch, payload, writeType)
+            result == BluetoothStatusCodes.SUCCESS
+        } else {
+            ch.writeType = writeType
+            ch.value = payload
+            gatt.writeCharacteristic(ch)
+        }
+    }
+}
@@ -2,6 +2,7 @@ package com.remotemotorcontroller.ui
 
 import android.os.Bundle
 import android.view.View
+import android.widget.TextView
 import androidx.core.content.ContextCompat
 import androidx.fragment.app.Fragment
 import androidx.fragment.app.activityViewModels
@@ -16,14 +17,20 @@ import com.github.mikephil.charting.data.LineDataSet
 import com.google.android.material.button.MaterialButton
 import com.remotemotorcontroller.R
 import com.remotemotorcontroller.adapter.AnalyticsViewModel
+import com.remotemotorcontroller.adapter.StepResponseAnalyzer
 import com.remotemotorcontroller.ble.BLEManager
 import kotlinx.coroutines.launch
 
 class AnalyticsFragment : Fragment(R.layout.fragment_analytics) {
 
+    companion object{
+        const val STEP_HISTORY_LINES = 3    // COMPLETED STEPS LISTED UNDER THE CURRENT ONE
+    }
+
     private lateinit var chart: LineChart
     private lateinit var startStopBtn: MaterialButton
     private lateinit var resetBtn: MaterialButton
+    private lateinit var stepMetricsText: TextView
 
     private lateinit var rpmData: LineDataSet
     private lateinit var angleData: LineDataSet
@@ -39,6 +46,7 @@ class AnalyticsFragment : Fragment(R.layout.fragment_analytics) {
         chart = view.findViewById(R.id.chartTelemetry)
         startStopBtn = view.findViewById(R.id.buttonPlayPause)
         resetBtn = view.findViewById(R.id.buttonReset)
+        stepMetricsText = view.findViewById(R.id.textStepMetrics)
 
         // Chart setup
         chart.apply {
@@ -97,11 +105,52 @@ class AnalyticsFragment : Fragment(R.layout.fragment_analytics) {
                     if(!paused){
                         updateGraph()
                     }
+                    updateStepMetrics()
                 }
             }
         }
 
         if(!paused) updateGraph()
+        updateStepMetrics()
+    }
+
+    private fun updateStepMetrics(){
+        val m = viewModel.stepAnalyzer.current()
+        val history = viewModel.stepAnalyzer.steps.takeLast(STEP_HISTORY_LINES).asReversed()
+        if(m == null && history.isEmpty()){
+            stepMetricsText.setText(R.string.step_metrics_idle)
+            return
+        }
+        stepMetricsText.text = buildString {
+            m?.let { append(formatStepMetrics(it)) }
+            if(history.isNotEmpty()){
+                if(m != null) appendLine().appendLine()
+                append("PREVIOUS (rise / over / settle)")
+                history.forEach { appendLine().append(formatStepSummary(it)) }
+            }
+        }
+    }
+
+    private fun formatStepMetrics(m: StepResponseAnalyzer.StepMetrics): String {
+        val unit = if(m.isPosition) "°" else " rpm"
+        fun ms(v: Long?) = v?.let { "$it ms" } ?: "–"
+        return buildString {
+            appendLine("STEP   ${m.initial} → ${m.target}$unit")
+            appendLine("RISE   ${ms(m.riseTimeMs)}")
+            appendLine("OVER   %.1f %%".format(m.overshootPct))
+            appendLine("SETTLE ${ms(m.settlingTimeMs)}")
+            appendLine("SSE    ${m.steadyStateError?.let { "%.1f$unit".format(it) } ?: "–"}")
+            appendLine("RIPPLE %.1f$unit".format(m.rippleRms))
+            append("MIN/MAX ${m.windowMin} / ${m.windowMax}$unit")
+        }
+    }
+
+    // ONE LINE PER COMPLETED STEP, NEWEST FIRST -> COMPARE TUNING RUNS WITHOUT READING THE LOG
+    private fun formatStepSummary(m: StepResponseAnalyzer.StepMetrics): String {
+        val unit = if(m.isPosition) "°" else " rpm"
+        return "→%d%s  %s / %.0f%% / %s".format(m.target, unit,
+            m.riseTimeMs?.let { "$it ms" } ?: "–", m.overshootPct,
+            m.settlingTimeMs?.let { "$it ms" } ?: "–")
     }
 
     public fun applyConfig(maxPts: Int){
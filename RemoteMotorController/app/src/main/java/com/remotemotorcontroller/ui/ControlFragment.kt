@@ -9,11 +9,18 @@ import android.widget.Toast
 import androidx.compose.material3.OutlinedButton
 import androidx.core.widget.doAfterTextChanged
 import androidx.fragment.app.Fragment
+import androidx.lifecycle.Lifecycle
+import androidx.lifecycle.lifecycleScope
+import androidx.lifecycle.repeatOnLifecycle
 import com.google.android.material.button.MaterialButton
 import com.google.android.material.button.MaterialButtonToggleGroup
+import com.google.android.material.materialswitch.MaterialSwitch
+import com.google.android.material.slider.Slider
 import com.google.android.material.textfield.TextInputEditText
 import com.remotemotorcontroller.R
+import com.remotemotorcontroller.ble.BLEContract
 import com.remotemotorcontroller.ble.BLEManager
+import kotlinx.coroutines.launch
 
 
 class ControlFragment : Fragment(R.layout.fragment_control) {
@@ -30,6 +37,10 @@ class ControlFragment : Fragment(R.layout.fragment_control) {
 
     private lateinit var angleToggleGroup: MaterialButtonToggleGroup
 
+    private lateinit var teleopSwitch: MaterialSwitch
+    private lateinit var teleopModeGroup: MaterialButtonToggleGroup
+    private lateinit var teleopSlider: Slider
+    private var syncingTeleop = false   // SWITCH MOVED BY BLEManager STATE, NOT BY THE USER
 
     override fun onViewCreated(view: View, savedInstanceState: Bundle?) {
         super.onViewCreated(view, savedInstanceState)
@@ -44,6 +55,10 @@ class ControlFragment : Fragment(R.layout.fragment_control) {
         rpmToggleGroup = view.findViewById(R.id.toggleRpmDirection)
         angleToggleGroup = view.findViewById(R.id.toggleAngleDirection)
 
+        teleopSwitch = view.findViewById(R.id.switchTeleop)
+        teleopModeGroup = view.findViewById(R.id.toggleTeleopMode)
+        teleopSlider = view.findViewById(R.id.sliderTeleop)
+
         restoreUiState()
 
         targetRpmEditText.doAfterTextChanged {
@@ -93,6 +108,45 @@ class ControlFragment : Fragment(R.layout.fragment_control) {
                 Toast.makeText(requireContext(), "Stopping motor", Toast.LENGTH_SHORT).show()
             }
         }
+        // LIVE JOG -> WHILE ON, BLEManager STREAMS THE SLIDER VALUE AT A FIXED RATE
+        // THE START/STOP BUTTON BECOMES STOP, SO THE MOTOR CAN ALWAYS BE STOPPED FROM ONE PLACE
+        teleopSwitch.setOnCheckedChangeListener { _, isChecked ->
+            if(syncingTeleop) return@setOnCheckedChangeListener
+            if(isChecked){
+                BLEManager.startTeleop(teleopCommand(), teleopSlider.value.toInt())
+                ControlUIState.isMotorRunning = true
+                setStopUi()
+            } else {
+                BLEManager.stopTeleop()
+                BLEManager.shutdown()   // DON'T WAIT FOR THE FIRMWARE'S STALL TIMEOUT
+                ControlUIState.isMotorRunning = false
+                setStartUi()
+            }
+            setDiscreteControlsEnabled(!isChecked)
+        }
+
+        // JOG ALSO ENDS WITHOUT THE SWITCH (STOP BUTTON, DISCONNECT) -> FOLLOW BLEManager
+        viewLifecycleOwner.lifecycleScope.launch {
+            viewLifecycleOwner.repeatOnLifecycle(Lifecycle.State.STARTED) {
+                BLEManager.teleopActive.collect { active -> syncTeleopUi(active) }
+            }
+        }
+
+        teleopSlider.addOnChangeListener { _, value, fromUser ->
+            ControlUIState.teleopValue = value
+            if(fromUser) BLEManager.setTeleopTarget(value.toInt())
+        }
+
+        teleopModeGroup.addOnButtonCheckedListener { _, checkedId, isChecked ->
+            if(!isChecked) return@addOnButtonCheckedListener
+            ControlUIState.isTeleopAngle = (checkedId == R.id.btnTeleopAngle)
+            setTeleopRange()
+            // THE SWITCH, NOT BLEManager -> ITS STATE LAGS UNTIL THE BLE THREAD HAS RUN startTeleop()
+            if(teleopSwitch.isChecked){
+                BLEManager.startTeleop(teleopCommand(), teleopSlider.value.toInt())
+            }
+        }
+
         sendAngleButton.setOnClickListener {
             var angle = targetAngleEditText.text.toString().toIntOrNull()
             if (angle != null) {
@@ -131,6 +185,48 @@ class ControlFragment : Fragment(R.layout.fragment_control) {
         } else {
             setStartUi()
         }
+
+        teleopModeGroup.check(if(ControlUIState.isTeleopAngle) R.id.btnTeleopAngle else R.id.btnTeleopRpm)
+        setTeleopRange()
+        teleopSlider.value = ControlUIState.teleopValue.coerceIn(teleopSlider.valueFrom, teleopSlider.valueTo)
+        syncTeleopUi(BLEManager.isTeleopActive())
+    }
+
+    private fun syncTeleopUi(active: Boolean){
+        if(teleopSwitch.isChecked != active){
+            syncingTeleop = true
+            teleopSwitch.isChecked = active
+            syncingTeleop = false
+            if(!active){
+                ControlUIState.isMotorRunning = false
+                setStartUi()
+            }
+        }
+        setDiscreteControlsEnabled(!active)
+    }
+
+    private fun teleopCommand(): Byte =
+        if(ControlUIState.isTeleopAngle) BLEContract.CMD_POSITION else BLEContract.CMD_SPEED
+
+    // RPM JOG IS CENTERED ON 0 (SIGN = DIRECTION), ANGLE JOG COVERS ONE TURN
+    private fun setTeleopRange(){
+        teleopSlider.value = 0f     // VALID IN BOTH RANGES
+        if(ControlUIState.isTeleopAngle){
+            teleopSlider.valueFrom = 0f
+            teleopSlider.valueTo = 359f
+            teleopSlider.stepSize = 1f
+        } else {
+            teleopSlider.valueFrom = -6000f
+            teleopSlider.valueTo = 6000f
+            teleopSlider.stepSize = 10f
+        }
+    }
+
+    // DISCRETE COMMANDS WOULD END THE STREAM ON THE FIRMWARE -> LOCK THEM WHILE JOGGING.
+    // NEVER THE START/STOP BUTTON -> STOP STAYS AVAILABLE IN EVERY MODE
+    private fun setDiscreteControlsEnabled(enabled: Boolean){
+        sendAngleButton.isEnabled = enabled
+        calibrateButton.isEnabled = enabled
     }
 
     private fun setStartUi() {
@@ -9,4 +9,8 @@ object ControlUIState {
     var isAngleCcw: Boolean = false
 
     var isMotorRunning = false
+
+    // LIVE JOG (STREAMED SETPOINTS)
+    var isTeleopAngle: Boolean = false
+    var teleopValue: Float = 0f
 }
\ No newline at end of file
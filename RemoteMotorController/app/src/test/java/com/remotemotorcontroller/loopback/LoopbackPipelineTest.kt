@@ -0,0 +1,210 @@
+package com.remotemotorcontroller.loopback
+
+import com.remotemotorcontroller.adapter.AnalyticsViewModel
+import com.remotemotorcontroller.ble.BLEContract
+import com.remotemotorcontroller.ble.BackfillTracker
+import com.remotemotorcontroller.ble.BleRequestQueue
+import com.remotemotorcontroller.ble.MotorCommand
+import com.remotemotorcontroller.ble.MotorCommander
+import com.remotemotorcontroller.ble.Telemetry
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.ExperimentalCoroutinesApi
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import kotlinx.coroutines.test.UnconfinedTestDispatcher
+import kotlinx.coroutines.test.resetMain
+import kotlinx.coroutines.test.setMain
+import org.junit.After
+import org.junit.Assert.assertEquals
+import org.junit.Assert.assertNotNull
+import org.junit.Assert.assertNull
+import org.junit.Assert.assertTrue
+import org.junit.Before
+import org.junit.Test
+
+// COMMAND -> REQUEST QUEUE -> LOOPBACK TRANSPORT -> SIMULATED MOTOR -> TELEMETRY -> ANALYTICS VIEWMODEL
+@OptIn(ExperimentalCoroutinesApi::class)
+class LoopbackPipelineTest {
+
+    private lateinit var scope: CoroutineScope
+    private lateinit var source: LoopbackSource
+    private lateinit var motor: SimulatedMotor
+    private lateinit var queue: BleRequestQueue
+    private lateinit var viewModel: AnalyticsViewModel
+    private lateinit var backfillTracker: BackfillTracker
+    private lateinit var commander: MotorCommander
+    @Volatile private var linkUp = true
+
+    @Before
+    fun setUp(){
+        // viewModelScope RUNS ON MAIN -> COLLECT SYNCHRONOUSLY ON WHICHEVER THREAD EMITS
+        Dispatchers.setMain(UnconfinedTestDispatcher())
+
+        scope = CoroutineScope(SupervisorJob())
+        source = LoopbackSource()
+        backfillTracker = BackfillTracker()
+        motor = SimulatedMotor(::onNotify, source::onHistory, BLEContract.REQUEST_MTU)  // WHAT BLEManager NEGOTIATES
+        val transport = LoopbackTransport(motor) { queue }
+        queue = BleRequestQueue(scope) { transport }
+        queue.start()
+        viewModel = AnalyticsViewModel(source)
+        commander = MotorCommander({ queue }, source::onCommand)    // SAME COMMAND PATH AS BLEManager
+    }
+
+    @After
+    fun tearDown(){
+        queue.stop()
+        scope.cancel()
+        Dispatchers.resetMain()
+    }
+
+    // TELEMETRY NOTIFICATION -> WHAT BLEManager.onCharacteristicChanged DOES, NOTHING ARRIVES WHILE THE LINK IS DOWN
+    private fun onNotify(value: ByteArray){
+        if(!linkUp) return
+        Telemetry.fromBytes(value)?.seq?.let { backfillTracker.onLiveSample(it) }
+        source.onNotify(value)
+    }
+
+    private fun awaitUntil(timeoutMs: Long = 2000, cond: () -> Boolean){
+        val deadline = System.currentTimeMillis() + timeoutMs
+        while(!cond()){
+            assertTrue("timed out waiting for the queue", System.currentTimeMillis() < deadline)
+            Thread.sleep(1)
+        }
+    }
+
+    @Test
+    fun speedStep_reachesTargetAndIsMeasured(){
+        commander.setSpeed(1000)
+        awaitUntil { motor.targetSpeed == 1000 }
+
+        repeat(100) { motor.tick() }
+
+        assertEquals(1000f, viewModel.rpmEntries.last().y)
+
+        val step = viewModel.stepAnalyzer.current()
+        assertNotNull(step)
+        assertNotNull(step!!.riseTimeMs)
+        assertNotNull(step.settlingTimeMs)
+        assertEquals(0f, step.overshootPct)
+        // RISE TIME COMES FROM DEVICE TIMESTAMPS -> WHOLE CONTROL PERIODS
+        assertEquals(0L, step.riseTimeMs!! % SimulatedMotor.PERIOD_MS)
+    }
+
+    @Test
+    fun positionStep_takesShortestPathAcrossZero(){
+        commander.setPosition(270)
+        awaitUntil { motor.targetPosition == 270 }
+
+        repeat(50) { motor.tick() }
+
+        assertEquals(270f, viewModel.angleEntries.last().y)
+        assertEquals(0, motor.speed)
+
+        // 0 -> 270 IS A 90 DEGREE TURN BACKWARDS, NEVER PAST 180
+        assertTrue(viewModel.angleEntries.all { it.y == 0f || it.y >= 180f })
+        assertNotNull(viewModel.stepAnalyzer.current()!!.settlingTimeMs)
+    }
+
+    @Test
+    fun newCommand_closesPreviousStep(){
+        commander.setSpeed(500)
+        awaitUntil { motor.targetSpeed == 500 }
+        repeat(60) { motor.tick() }
+
+        commander.shutdown()
+        awaitUntil { motor.targetSpeed == 0 }
+        repeat(60) { motor.tick() }
+
+        assertEquals(1, viewModel.stepAnalyzer.steps.size)
+        assertEquals(500, viewModel.stepAnalyzer.steps[0].target)
+        assertEquals(0f, viewModel.rpmEntries.last().y)
+    }
+
+    @Test
+    fun stepStartsWhenTheFirmwareAppliesTheCommand(){
+        commander.setSpeed(500)
+        awaitUntil { motor.targetSpeed == 500 }
+        repeat(60) { motor.tick() }
+
+        // PUBLISHED BUT STILL IN FLIGHT -> THE MOTOR KEEPS RUNNING ON THE OLD SETPOINT, NO STEP YET
+        source.onCommand(MotorCommand(BLEContract.CMD_SPEED, 1000))
+        repeat(10) { motor.tick() }
+        assertNull(viewModel.stepAnalyzer.current())
+
+        MotorCommander({ queue }).setSpeed(1000)    // THE WRITE ITSELF, ALREADY PUBLISHED ABOVE
+        awaitUntil { motor.targetSpeed == 1000 }
+        repeat(60) { motor.tick() }
+
+        // MEASURED FROM THE PRE-STEP VALUE, NOT FROM A SAMPLE THAT WAS ALREADY MOVING
+        val step = viewModel.stepAnalyzer.current()!!
+        assertEquals(500, step.initial)
+        assertEquals(1000, step.target)
+        assertEquals(0f, step.overshootPct)
+    }
+
+    @Test
+    fun linkLossWithErrorStatus_backfillsTheGap(){
+        commander.setSpeed(1000)
+        awaitUntil { motor.targetSpeed == 1000 }
+        repeat(20) { motor.tick() }
+
+        // SUPERVISION TIMEOUT -> onConnectionStateChange(status = 8), NOT A USER DISCONNECT
+        linkUp = false
+        backfillTracker.onLinkLost()
+        val resumeFrom = backfillTracker.lastSeq!! + 1
+        repeat(40) { motor.tick() }
+
+        // RECONNECT -> HISTORY CCC WRITTEN, BLEManager.requestBackfill()
+        linkUp = true
+        assertEquals(resumeFrom, backfillTracker.requestBackfill(queue))
+        awaitUntil { motor.historyServed == 1 }
+        repeat(10) { motor.tick() }
+
+        // ONE ENTRY PER TICK, NO HOLE WHERE THE LINK WAS DOWN
+        val xs = rpmXs()
+        assertEquals((xs.first()..xs.last()).toList(), xs)
+        assertEquals(70L, xs.last() - xs.first() + 1)
+    }
+
+    @Test
+    fun userDisconnect_requestsNoBackfill(){
+        commander.setSpeed(1000)
+        awaitUntil { motor.targetSpeed == 1000 }
+        repeat(20) { motor.tick() }
+
+        backfillTracker.onLinkLost()
+        backfillTracker.onUserDisconnect()
+
+        assertNull(backfillTracker.requestBackfill(queue))
+    }
+
+    @Test
+    fun streamAfterDeviceRestart_continuesTheSeries(){
+        source.onStream((100L until 110L).map { Telemetry(0, 500, 0, it, it * 15) })
+
+        // FIRMWARE REBOOTED -> SEQ STARTS OVER, THE STREAM MUST NOT PLOT IT BEFORE THE RECORDING
+        source.onStream((0L until 5L).map { Telemetry(0, 700, 0, it, it * 15) })
+
+        assertEquals((0L until 15L).toList(), rpmXs())
+        assertEquals(700f, viewModel.rpmEntries.last().y)
+    }
+
+    @Test
+    fun backfillBeforeTheRecording_isDroppedNotRebased(){
+        source.onStream((100L until 110L).map { Telemetry(0, 500, 0, it, it * 15) })
+
+        // HISTORY THE CHART NEVER COVERED (E.G. AFTER A RESET) -> NOT A RESTART, NOTHING TO PLOT
+        source.onHistory(byteArrayOf(2) + sample(90) + sample(91))
+
+        assertEquals((0L until 10L).toList(), rpmXs())
+    }
+
+    private fun sample(seq: Long): ByteArray =
+        byteArrayOf(0, 0, 0, 0, 0, 0, 0, 0, 0,
+            seq.toByte(), (seq shr 8).toByte(), (seq shr 16).toByte(), (seq shr 24).toByte(),
+            0, 0, 0, 0)
+
+    private fun rpmXs(): List<Long> = viewModel.rpmEntries.map { it.x.toLong() }
+}
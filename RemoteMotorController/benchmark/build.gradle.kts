@@ -0,0 +1,47 @@
+import org.jetbrains.kotlin.gradle.dsl.JvmTarget
+
+// JMH MICRO BENCHMARKS FOR THE BLE PIPELINE (kotlinx-benchmark) -> ./gradlew :benchmark:benchmark
+// RESULTS LAND IN build/reports/benchmarks/. THE gc PROFILER ADDS gc.alloc.rate.norm = BYTES PER OPERATION
+plugins {
+    alias(libs.plugins.kotlin.jvm)
+    alias(libs.plugins.kotlin.allopen)
+    alias(libs.plugins.kotlinx.benchmark)
+}
+
+java {
+    sourceCompatibility = JavaVersion.VERSION_11
+    targetCompatibility = JavaVersion.VERSION_11
+}
+
+kotlin {
+    compilerOptions {
+        jvmTarget.set(JvmTarget.JVM_11)
+    }
+}
+
+// JMH SUBCLASSES THE @State CLASSES
+allOpen {
+    annotation("org.openjdk.jmh.annotations.State")
+}
+
+dependencies {
+    implementation(project(":core"))
+    implementation(testFixtures(project(":core")))
+    implementation(libs.kotlinx.benchmark.runtime)
+}
+
+benchmark {
+    targets {
+        register("main")
+    }
+    configurations {
+        named("main") {
+            warmups = 5
+            iterations = 10
+            iterationTime = 1
+            iterationTimeUnit = "s"
+            advanced("jvmForks", 2)
+            advanced("jvmProfiler", "gc")
+        }
+    }
+}
@@ -0,0 +1,82 @@
+package com.remotemotorcontroller.benchmark
+
+import com.remotemotorcontroller.ble.BLEContract
+import com.remotemotorcontroller.ble.BleRequestQueue
+import com.remotemotorcontroller.ble.MotorTransport
+import com.remotemotorcontroller.loopback.LoopbackTransport
+import com.remotemotorcontroller.loopback.SimulatedMotor
+import kotlinx.coroutines.CoroutineScope
+import kotlinx.coroutines.Dispatchers
+import kotlinx.coroutines.SupervisorJob
+import kotlinx.coroutines.cancel
+import org.openjdk.jmh.annotations.Benchmark
+import org.openjdk.jmh.annotations.BenchmarkMode
+import org.openjdk.jmh.annotations.Level
+import org.openjdk.jmh.annotations.Mode
+import org.openjdk.jmh.annotations.OperationsPerInvocation
+import org.openjdk.jmh.annotations.OutputTimeUnit
+import org.openjdk.jmh.annotations.Param
+import org.openjdk.jmh.annotations.Scope
+import org.openjdk.jmh.annotations.Setup
+import org.openjdk.jmh.annotations.State
+import org.openjdk.jmh.annotations.TearDown
+import java.util.UUID
+import java.util.concurrent.CountDownLatch
+import java.util.concurrent.TimeUnit
+
+// BleRequestQueue OVERHEAD PER WRITE -> A BURST OF COMMAND WRITES DRAINED THROUGH THE LOOPBACK TRANSPORT.
+// NO_RESPONSE MEASURES THE QUEUE LOOP ALONE, DEFAULT ADDS THE onWriteComplete() HANDSHAKE OF AN ACKED WRITE
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+class QueueLatencyBenchmark {
+
+    companion object{
+        const val BURST = 1000
+    }
+
+    @Param("NO_RESPONSE", "DEFAULT")
+    var writeType = "NO_RESPONSE"
+
+    private lateinit var scope: CoroutineScope
+    private lateinit var queue: BleRequestQueue
+    private lateinit var payloads: List<ByteArray>
+    private var type = BLEContract.WRITE_TYPE_NO_RESPONSE
+    @Volatile private var drained = CountDownLatch(0)
+
+    // COUNTS THE WRITES THAT MADE IT OUT OF THE QUEUE
+    private class CountingTransport(
+        private val inner: MotorTransport,
+        private val onWrite: () -> Unit
+    ) : MotorTransport {
+        override fun write(charUuid: UUID, payload: ByteArray, writeType: Int): Boolean =
+            inner.write(charUuid, payload, writeType).also { onWrite() }
+    }
+
+    @Setup(Level.Trial)
+    fun startQueue(){
+        type = if(writeType == "DEFAULT") BLEContract.WRITE_TYPE_DEFAULT else BLEContract.WRITE_TYPE_NO_RESPONSE
+        payloads = List(BURST) { BLEContract.commandPayload(BLEContract.CMD_SPEED, it) }
+
+        scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
+        val transport = CountingTransport(LoopbackTransport(SimulatedMotor()) { queue }) { drained.countDown() }
+        queue = BleRequestQueue(scope) { transport }
+        queue.start()
+    }
+
+    @TearDown(Level.Trial)
+    fun stopQueue(){
+        queue.stop()
+        scope.cancel()
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(BURST)
+    fun burst(){
+        drained = CountDownLatch(BURST)
+        for(p in payloads){
+            queue.enqueueWrite(BLEContract.CHAR_CMD, p, type, BleRequestQueue.PRIORITY_LOW)
+        }
+        check(drained.await(10, TimeUnit.SECONDS)) { "queue did not drain" }
+    }
+}
@@ -0,0 +1,57 @@
+package com.remotemotorcontroller.benchmark
+
+import com.remotemotorcontroller.adapter.StepResponseAnalyzer
+import com.remotemotorcontroller.ble.BLEContract
+import com.remotemotorcontroller.ble.Telemetry
+import com.remotemotorcontroller.loopback.SimulatedMotor
+import org.openjdk.jmh.annotations.Benchmark
+import org.openjdk.jmh.annotations.BenchmarkMode
+import org.openjdk.jmh.annotations.Mode
+import org.openjdk.jmh.annotations.OperationsPerInvocation
+import org.openjdk.jmh.annotations.OutputTimeUnit
+import org.openjdk.jmh.annotations.Scope
+import org.openjdk.jmh.annotations.Setup
+import org.openjdk.jmh.annotations.State
+import java.util.concurrent.TimeUnit
+
+// PER-SAMPLE COST OF THE STEP RESPONSE METRICS -> TWO SPEED STEPS (UP, THEN BACK DOWN) REPLAYED EVERY INVOCATION.
+// EACH STEP TOGGLES THE ACK BIT ONCE, SO AFTER BOTH THE ANALYZER IS BACK WHERE THE NEXT INVOCATION EXPECTS IT
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+class StepAnalyzerBenchmark {
+
+    companion object{
+        const val TICKS_PER_STEP = 200      // 3 s OF CONTROL TICKS -> PAST SETTLING
+        const val UP_RPM = 3000
+        const val DOWN_RPM = 0
+    }
+
+    private val analyzer = StepResponseAnalyzer()
+    private lateinit var up: List<Telemetry>
+    private lateinit var down: List<Telemetry>
+
+    @Setup
+    fun recordSteps(){
+        val motor = SimulatedMotor()
+        fun step(rpm: Int): List<Telemetry> {
+            motor.onCommand(BLEContract.CMD_SPEED, rpm)
+            return List(TICKS_PER_STEP) {
+                motor.tick()
+                Telemetry.fromBytes(motor.pack())!!
+            }
+        }
+        up = step(UP_RPM)
+        down = step(DOWN_RPM)
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(2 * TICKS_PER_STEP)
+    fun onSample(): StepResponseAnalyzer.StepMetrics? {
+        analyzer.onCommand(false, UP_RPM)
+        for(t in up) analyzer.onSample(t.timeMs!!, t.status, t.rpm, t.angle)
+        val finished = analyzer.onCommand(false, DOWN_RPM)
+        for(t in down) analyzer.onSample(t.timeMs!!, t.status, t.rpm, t.angle)
+        return finished
+    }
+}
@@ -0,0 +1,53 @@
+package com.remotemotorcontroller.benchmark
+
+import com.remotemotorcontroller.ble.BLEContract
+import com.remotemotorcontroller.ble.Telemetry
+import com.remotemotorcontroller.loopback.SimulatedMotor
+import org.openjdk.jmh.annotations.Benchmark
+import org.openjdk.jmh.annotations.BenchmarkMode
+import org.openjdk.jmh.annotations.Mode
+import org.openjdk.jmh.annotations.OperationsPerInvocation
+import org.openjdk.jmh.annotations.OutputTimeUnit
+import org.openjdk.jmh.annotations.Scope
+import org.openjdk.jmh.annotations.Setup
+import org.openjdk.jmh.annotations.State
+import org.openjdk.jmh.infra.Blackhole
+import java.util.concurrent.TimeUnit
+
+// DECODE COST OF THE L2CAP STREAM -> ONE SDU OF REAL SIMULATOR OUTPUT, SCORED PER SAMPLE
+@State(Scope.Benchmark)
+@BenchmarkMode(Mode.AverageTime)
+@OutputTimeUnit(TimeUnit.NANOSECONDS)
+class TelemetryDecodeBenchmark {
+
+    companion object{
+        const val SDU_BATCH = 24    // CONFIG_APP_TELEMETRY_STREAM_BATCH
+    }
+
+    private lateinit var sdu: ByteArray
+
+    // [COUNT le16][COUNT x 17 BYTES] -> SAME LAYOUT BLEManager.handleStreamSdu() RECEIVES
+    @Setup
+    fun buildSdu(){
+        val motor = SimulatedMotor()
+        motor.onCommand(BLEContract.CMD_SPEED, 3000)
+        sdu = ByteArray(2 + SDU_BATCH * Telemetry.SIZE)
+        sdu[0] = SDU_BATCH.toByte()
+        for(i in 0 until SDU_BATCH){
+            motor.tick()
+            motor.pack().copyInto(sdu, 2 + i * Telemetry.SIZE)
+        }
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(SDU_BATCH)
+    fun fromBytes(bh: Blackhole){
+        for(i in 0 until SDU_BATCH){
+            bh.consume(Telemetry.fromBytes(sdu, 2 + i * Telemetry.SIZE))
+        }
+    }
+
+    @Benchmark
+    @OperationsPerInvocation(SDU_BATCH)
+    fun listFromBytes(): List<Telemetry> = Telemetry.listFromBytes(sdu, 2, SDU_BATCH)
+}
@@ -0,0 +1,23 @@
+import org.jetbrains.kotlin.gradle.dsl.JvmTarget
+
+// THE ANDROID-FREE PART OF THE BLE PIPELINE -> THE APP BUILDS ON IT, :benchmark MEASURES IT ON A PLAIN JVM.
+// testFixtures HOLDS THE LOOPBACK SIMULATOR SHARED BY THE APP'S PIPELINE TESTS AND THE BENCHMARKS
+plugins {
+    alias(libs.plugins.kotlin.jvm)
+    `java-test-fixtures`
+}
+
+java {
+    sourceCompatibility = JavaVersion.VERSION_11
+    targetCompatibility = JavaVersion.VERSION_11
+}
+
+kotlin {
+    compilerOptions {
+        jvmTarget.set(JvmTarget.JVM_11)
+    }
+}
+
+dependencies {
+    api(libs.kotlinx.coroutines.core)
+}
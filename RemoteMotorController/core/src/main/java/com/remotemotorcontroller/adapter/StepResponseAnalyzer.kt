@@ -0,0 +1,248 @@
+package com.remotemotorcontroller.adapter
+
+import kotlin.math.abs
+import kotlin.math.max
+import kotlin.math.sqrt
+
+// INCREMENTAL STEP RESPONSE METRICS -> EVERY onSample IS O(1) (AMORTIZED FOR THE MIN/MAX DEQUES)
+// OVER PRIMITIVE STATE. TIMES COME FROM THE DEVICE TIMESTAMP, NOT FROM SAMPLE COUNTS.
+// A STEP STARTS WHERE THE FIRMWARE APPLIED THE COMMAND (CMD_ACK FLIP), NOT WHERE THE APP SENT IT,
+// SO QUEUEING AND RADIO LATENCY ARE NOT PART OF THE MEASURED RESPONSE
+class StepResponseAnalyzer(private val window: Int = 64) {
+
+    companion object{
+        const val CMD_ACK_FLAG = 0x80   // MOTOR_FLAG_CMD_ACK -> TOGGLES ON EVERY ACCEPTED COMMAND
+        const val SETTLE_PCT = 0.02f    // SETTLING BAND = 2% OF THE STEP SIZE...
+        const val MIN_BAND_RPM = 5      // ...BUT NEVER TIGHTER THAN THE SENSOR CAN RESOLVE
+        const val MIN_BAND_DEG = 1
+        const val MAX_LOGGED_STEPS = 100
+    }
+
+    data class StepMetrics(
+        val isPosition: Boolean,
+        val target: Int,
+        val initial: Int,
+        val elapsedMs: Long,
+        val riseTimeMs: Long?,          // 10% -> 90% OF THE STEP
+        val overshootPct: Float,        // PEAK PAST THE TARGET, % OF THE STEP
+        val settlingTimeMs: Long?,      // NULL WHILE OUTSIDE THE SETTLING BAND
+        val steadyStateError: Float?,   // TARGET - WINDOW MEAN, ONLY ONCE SETTLED
+        val rippleRms: Float,           // RMS AROUND THE WINDOW MEAN
+        val windowMin: Int,
+        val windowMax: Int
+    )
+
+    // ROLLING WINDOW OVER THE LAST `window` SAMPLES (INDEPENDENT OF STEPS)
+    private val ring = IntArray(window)
+    private var sampleCount = 0L
+    private var sum = 0L
+    private var sumSq = 0.0
+    private val minDeque = ExtremeDeque(window, isMax = false)
+    private val maxDeque = ExtremeDeque(window, isMax = true)
+
+    // CURRENT STEP
+    private var active = false
+    private var isPosition = false
+    private var target = 0
+    private var initial: Int? = null
+    private var t0 = 0L
+    private var lastT = 0L
+    private var t10: Long? = null
+    private var t90: Long? = null
+    private var peakFraction = 0f
+    private var enteredBandMs: Long? = null
+
+    // STEP START -> WAIT FOR THE ACK BIT TO DIFFER FROM WHAT IT WAS WHEN THE COMMAND WENT OUT
+    private var ackBit: Int? = null         // BIT IN THE NEWEST SAMPLE
+    private var awaitingAckFrom: Int? = null
+    private var hasPrev = false             // NEWEST SAMPLE -> THE PRE-STEP VALUE ONCE THE ACK SHOWS UP
+    private var prevRpm = 0
+    private var prevAngle = 0
+
+    private val _steps = ArrayDeque<StepMetrics>()
+    val steps: List<StepMetrics> get() = _steps     // COMPLETED STEPS, OLDEST FIRST
+
+    // A COMMAND WENT OUT -> CLOSE THE PREVIOUS STEP, THE NEW ONE STARTS WHEN THE FIRMWARE ACKS IT
+    fun onCommand(isPosition: Boolean, target: Int): StepMetrics? {
+        val finished = closeStep()
+
+        // ROLLING STATS ARE PER SIGNAL -> RESTART THEM WHEN SWITCHING BETWEEN RPM AND ANGLE
+        if(isPosition != this.isPosition) resetWindow()
+
+        active = true
+        this.isPosition = isPosition
+        this.target = if(isPosition) Math.floorMod(target, 360) else target
+        initial = null
+        t10 = null
+        t90 = null
+        peakFraction = 0f
+        enteredBandMs = null
+        awaitingAckFrom = ackBit    // NO SAMPLE SEEN YET -> THE FIRST ONE STARTS THE STEP
+
+        return finished
+    }
+
+    fun onSample(timeMs: Long, status: Int, rpm: Int, angle: Int){
+        val y = measure(rpm, angle)
+        pushWindow(y)
+
+        val bit = status and CMD_ACK_FLAG
+        val prevY = if(hasPrev) measure(prevRpm, prevAngle) else y
+        ackBit = bit
+        hasPrev = true
+        prevRpm = rpm
+        prevAngle = angle
+
+        if(!active) return
+
+        if(initial == null){
+            val ref = awaitingAckFrom
+            if(ref != null && bit == ref) return    // FIRMWARE STILL ON THE PREVIOUS SETPOINT
+
+            // FIRST TICK ON THE NEW SETPOINT -> t0 IS ITS TIMESTAMP, THE STEP STARTS FROM THE VALUE BEFORE IT.
+            // (GATT ONLY NOTIFIES ON CHANGE, SO THE PREVIOUS SAMPLE'S TIME MAY BE LONG BEFORE THE COMMAND)
+            initial = if(ref != null) prevY else y
+            t0 = timeMs
+        }
+        val y0 = initial!!
+        lastT = timeMs
+
+        val step = target - y0
+        val minBand = if(isPosition) MIN_BAND_DEG else MIN_BAND_RPM
+        val band = max(abs(step) * SETTLE_PCT, minBand.toFloat())
+
+        if(step != 0){
+            val fraction = (y - y0).toFloat() / step
+            if(t10 == null && fraction >= 0.1f) t10 = timeMs
+            if(t90 == null && fraction >= 0.9f) t90 = timeMs
+            if(fraction > peakFraction) peakFraction = fraction
+        }
+
+        val inside = abs(target - y) <= band
+        if(!inside){
+            enteredBandMs = null
+        } else if(enteredBandMs == null){
+            enteredBandMs = timeMs
+        }
+    }
+
+    // SNAPSHOT OF THE CURRENT STEP -> ONLY ALLOCATES WHEN THE UI ASKS
+    fun current(): StepMetrics? {
+        val y0 = initial ?: return null
+        if(!active) return null
+
+        val n = minOf(sampleCount, window.toLong()).toInt()
+        val mean = if(n > 0) sum.toDouble() / n else 0.0
+        val variance = if(n > 0) max(sumSq / n - mean * mean, 0.0) else 0.0
+
+        val settling = enteredBandMs?.let { it - t0 }
+        val rise = t10?.let { a -> t90?.let { b -> b - a } }
+
+        return StepMetrics(
+            isPosition = isPosition,
+            target = target,
+            initial = y0,
+            elapsedMs = lastT - t0,
+            riseTimeMs = rise,
+            overshootPct = max(0f, (peakFraction - 1f) * 100f),
+            settlingTimeMs = settling,
+            steadyStateError = if(settling != null) (target - mean).toFloat() else null,
+            rippleRms = sqrt(variance).toFloat(),
+            windowMin = if(n > 0) minDeque.value() else 0,
+            windowMax = if(n > 0) maxDeque.value() else 0
+        )
+    }
+
+    // RUN ENDED (RESET / DISCONNECT) -> CLOSE THE CURRENT STEP WITHOUT STARTING ANOTHER
+    fun finish(): StepMetrics? {
+        val finished = closeStep()
+        active = false
+        return finished
+    }
+
+    private fun closeStep(): StepMetrics? {
+        val finished = current() ?: return null
+        _steps.addLast(finished)
+        if(_steps.size > MAX_LOGGED_STEPS) _steps.removeFirst()
+        return finished
+    }
+
+    fun reset(){
+        active = false
+        initial = null
+        awaitingAckFrom = null
+        ackBit = null
+        hasPrev = false
+        _steps.clear()
+        resetWindow()
+    }
+
+    // POSITION IS MEASURED ON THE SHORTEST PATH TO THE TARGET SO 359 -> 1 IS A 2 DEGREE STEP
+    private fun measure(rpm: Int, angle: Int): Int =
+        if(isPosition) target - wrapDelta(target - angle) else rpm
+
+    private fun resetWindow(){
+        sampleCount = 0
+        sum = 0
+        sumSq = 0.0
+        minDeque.clear()
+        maxDeque.clear()
+    }
+
+    private fun pushWindow(y: Int){
+        val slot = (sampleCount % window).toInt()
+        if(sampleCount >= window){
+            val old = ring[slot]
+            sum -= old
+            sumSq -= old.toDouble() * old
+        }
+        ring[slot] = y
+        sum += y
+        sumSq += y.toDouble() * y
+
+        minDeque.push(sampleCount, y)
+        maxDeque.push(sampleCount, y)
+        sampleCount++
+    }
+
+    /* map an angle difference into [-180, 180] (shortest rotation) */
+    private fun wrapDelta(d: Int): Int {
+        var a = d % 360
+        if(a > 180) a -= 360
+        if(a < -180) a += 360
+        return a
+    }
+
+    // MONOTONIC DEQUE OVER PRIMITIVE ARRAYS -> FRONT IS THE WINDOW MIN (OR MAX)
+    private class ExtremeDeque(private val window: Int, private val isMax: Boolean){
+        private val capacity = window + 1
+        private val index = LongArray(capacity)
+        private val values = IntArray(capacity)
+        private var head = 0
+        private var size = 0
+
+        fun push(n: Long, v: Int){
+            // EXPIRE SAMPLES THAT LEFT THE WINDOW
+            while(size > 0 && index[head] <= n - window){
+                head = (head + 1) % capacity
+                size--
+            }
+            // DROP SAMPLES THAT CAN NEVER BE THE EXTREME AGAIN
+            while(size > 0){
+                val back = values[(head + size - 1) % capacity]
+                if(if(isMax) back <= v else back >= v) size-- else break
+            }
+            val pos = (head + size) % capacity
+            index[pos] = n
+            values[pos] = v
+            size++
+        }
+
+        fun value(): Int = values[head]
+
+        fun clear(){
+            head = 0
+            size = 0
+        }
+    }
+}
@@ -0,0 +1,58 @@
+package com.remotemotorcontroller.ble
+
+import java.util.UUID
+
+object BLEContract {
+    val SERVICE_MOTOR: UUID = UUID.fromString("c52081ba-e90f-40e4-a99f-ccaa4fd11c15")
+    val CHAR_CMD: UUID = UUID.fromString("d10b46cd-412a-4d15-a7bb-092a329eed46")
+
+    val CHAR_HEARTBEAT: UUID = UUID.fromString("2215d558-c569-4bd1-8947-b4fd5f9432a0")
+    val CHAR_TELEM: UUID = UUID.fromString("17da15e5-05b1-42df-8d9d-d7645d6d9293")
+    val CHAR_HISTORY: UUID = UUID.fromString("6a3e0c2f-8b1d-4f5a-9c47-2e81d05b7a13")
+    val CHAR_SETPOINT: UUID = UUID.fromString("9f4b7d21-3c6e-4a88-b5d2-71e0c3a95f64")
+
+    val DESC_CCCD: UUID = UUID.fromString("00002902-0000-1000-8000-00805f9b34fb")
+
+    // LE PSM OF THE FIRMWARE'S L2CAP COC TELEMETRY STREAM (CONFIG_APP_TELEMETRY_STREAM_PSM)
+    const val STREAM_PSM = 0x81
+
+    // ATT WRITE TYPES -> SAME VALUES AS BluetoothGattCharacteristic.WRITE_TYPE_*, SO THIS MODULE STAYS PLAIN JVM
+    const val WRITE_TYPE_NO_RESPONSE = 1
+    const val WRITE_TYPE_DEFAULT = 2
+
+    const val CMD_SHUTDOWN:  Byte = 0x00
+    const val CMD_CALIBRATE: Byte = 0x01
+    const val CMD_SPEED:     Byte = 0x02
+    const val CMD_POSITION:  Byte = 0x03
+
+    // ATT MTU REQUESTED ON CONNECT -> THE DEFAULT 23 ONLY FITS ONE HISTORY SAMPLE PER NOTIFICATION
+    const val ATT_MTU_DEFAULT = 23
+    const val REQUEST_MTU = 247
+
+    // SAME PACKING AS history_work_fn() -> [COUNT (1 BYTE)] + SAMPLES IN (MTU - 3 BYTE ATT HEADER)
+    fun historySamplesPerPdu(mtu: Int): Int = maxOf(1, (mtu - 3 - 1) / Telemetry.SIZE)
+
+    // STREAMED SETPOINTS (TELEOPERATION) -> 50 Hz, FIRMWARE STOPS THE MOTOR AFTER 200 ms WITHOUT ONE
+    const val SETPOINT_PERIOD_MS = 20L
+
+    // [CMD (1 BYTE)] [VALUE (4 BYTES, LE)]
+    fun commandPayload(cmd: Byte, value: Int): ByteArray {
+        return byteArrayOf(
+            cmd,
+            (value and 0xFF).toByte(),
+            ((value shr 8) and 0xFF).toByte(),
+            ((value shr 16) and 0xFF).toByte(),
+            ((value shr 24) and 0xFF).toByte()
+        )
+    }
+    // HISTORY WRITE -> [FROM_SEQ (4 BYTES, LE)]
+    fun historyRequestPayload(fromSeq: Long): ByteArray {
+        val seq = fromSeq.toInt()
+        return byteArrayOf(
+            (seq and 0xFF).toByte(),
+            ((seq shr 8) and 0xFF).toByte(),
+            ((seq shr 16) and 0xFF).toByte(),
+            ((seq shr 24) and 0xFF).toByte()
+        )
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+package com.remotemotorcontroller.ble
+
+import java.util.UUID
+
+// WHERE THE NEXT BACKFILL STARTS -> KEPT OUT OF BLEManager SO THE LOOPBACK TESTS DRIVE THE SAME BOOKKEEPING.
+// NOT THREAD SAFE, BLEManager ONLY USES IT FROM THE BLE THREAD
+class BackfillTracker {
+
+    var lastSeq: Long? = null       // NEWEST LIVE SAMPLE SEEN ON THIS SESSION
+        private set
+    private var fromSeq: Long? = null   // FIRST SAMPLE MISSED BY THE LAST DROPOUT
+
+    fun onLiveSample(seq: Long){
+        lastSeq = seq
+    }
+
+    // ANY LINK LOSS THE USER DID NOT ASK FOR -> A CLEAN DISCONNECT AND AN ERROR STATUS
+    // (SUPERVISION TIMEOUT 8, PEER TERMINATED 19, 133...) LEAVE THE SAME GAP
+    fun onLinkLost(){
+        lastSeq?.let { fromSeq = it + 1 }
+    }
+
+    // USER ENDED THE SESSION -> NOTHING TO BACKFILL ON THE NEXT CONNECTION
+    fun onUserDisconnect(){
+        lastSeq = null
+        fromSeq = null
+    }
+
+    // QUEUE ONE HISTORY REQUEST FOR THE PENDING GAP -> RETURNS ITS START SEQ, NULL IF THERE WAS NO GAP
+    fun requestBackfill(queue: BleRequestQueue, charUuid: UUID = BLEContract.CHAR_HISTORY): Long? {
+        val from = fromSeq ?: return null
+        fromSeq = null
+
+        queue.enqueueWrite(
+            charUuid = charUuid,
+            data = BLEContract.historyRequestPayload(from),
+            writeType = BLEContract.WRITE_TYPE_DEFAULT,
+            priority = BleRequestQueue.PRIORITY_LOW
+        )
+        return from
+    }
+}
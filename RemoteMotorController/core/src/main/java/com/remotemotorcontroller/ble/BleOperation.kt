@@ -1,11 +1,11 @@
 package com.remotemotorcontroller.ble
 
-import android.bluetooth.BluetoothGattCharacteristic
+import java.util.UUID
 
 sealed class BleOperation : Comparable<BleOperation>{
     abstract val priority: Int  // HIGHER NUMBER = HIGHER PRIORITY
     data class Write(
-        val characteristic: BluetoothGattCharacteristic,
+        val charUuid: UUID,
         val payload: ByteArray,
         val writeType: Int,     // WRITE_TYPE_DEFAULT OR WRITE_TYPE_NO_RESPONSE
         override val priority: Int = 0
@@ -21,14 +21,14 @@ sealed class BleOperation : Comparable<BleOperation>{
 
             other as Write
 
-            if (characteristic != other.characteristic) return false
+            if (charUuid != other.charUuid) return false
             if (!payload.contentEquals(other.payload)) return false
 
             return true
         }
 
         override fun hashCode(): Int {
-            var result = characteristic.hashCode()
+            var result = charUuid.hashCode()
             result = 31 * result + payload.contentHashCode()
             return result
         }
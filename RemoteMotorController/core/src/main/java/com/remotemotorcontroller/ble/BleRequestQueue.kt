@@ -1,11 +1,5 @@
 package com.remotemotorcontroller.ble
 
-import android.annotation.SuppressLint
-import android.bluetooth.BluetoothGatt
-import android.bluetooth.BluetoothGattCharacteristic
-import android.bluetooth.BluetoothStatusCodes
-import android.os.Build
-import android.util.Log
 import kotlinx.coroutines.CoroutineScope
 import kotlinx.coroutines.Dispatchers
 import kotlinx.coroutines.Job
@@ -14,12 +8,21 @@ import kotlinx.coroutines.isActive
 import kotlinx.coroutines.launch
 import kotlinx.coroutines.sync.Mutex
 import kotlinx.coroutines.sync.withLock
+import kotlinx.coroutines.withContext
 import kotlinx.coroutines.withTimeoutOrNull
+import java.util.UUID
 import java.util.concurrent.PriorityBlockingQueue
+import kotlin.coroutines.CoroutineContext
+import kotlin.coroutines.EmptyCoroutineContext
 
+// transportContext -> WHERE THE TRANSPORT IS LOOKED UP AND WRITTEN TO (BLEManager PASSES ITS BLE THREAD,
+// WHICH OWNS THE GATT). ONLY THE BLOCKING take() RUNS ON IO
+// logError -> PLAIN JVM MODULE, SO BLEManager PLUGS IN android.util.Log
 class BleRequestQueue(
     private val scope: CoroutineScope,
-    private val gattProvider: () -> BluetoothGatt?
+    private val transportContext: CoroutineContext = EmptyCoroutineContext,
+    private val logError: (String) -> Unit = {},
+    private val transportProvider: () -> MotorTransport?
     ) {
     private val queue = PriorityBlockingQueue<BleOperation>()
 
@@ -30,6 +33,7 @@ class BleRequestQueue(
     companion object {
         const val PRIORITY_CRITICAL = 100
         const val PRIORITY_HIGH = 50
+        const val PRIORITY_STREAM = 25
         const val PRIORITY_LOW = 1
     }
 
@@ -46,25 +50,26 @@ class BleRequestQueue(
                 }
 
                 // ATTEMPT TO EXECUTE ON THE BLE
-                val gatt = gattProvider()
-                if (gatt == null) {
-                    Log.e("BLE", "GATT IS NULL, DROPPING EXPRESSION")
-                    continue
-                }
-
                 when (op) {
-                    is BleOperation.Write -> processWrite(gatt, op)
+                    is BleOperation.Write -> processWrite(op)
                 }
             }
         }
     }
 
-    private suspend fun processWrite(gatt: BluetoothGatt, op: BleOperation.Write){
-        val isWriteWithResponse = (op.writeType == BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT)
+    private suspend fun processWrite(op: BleOperation.Write){
+        val isWriteWithResponse = (op.writeType == BLEContract.WRITE_TYPE_DEFAULT)
 
         if(!callbackSignal.isLocked) callbackSignal.tryLock()
 
-        val success = executeWrite(gatt, op)
+        // NULL -> NO LINK, THE WRITE IS DROPPED
+        val success = withContext(transportContext) {
+            transportProvider()?.write(op.charUuid, op.payload, op.writeType)
+        }
+        if(success == null){
+            logError("GATT IS NULL, DROPPING EXPRESSION")
+            return
+        }
 
         if(success && isWriteWithResponse){
 
@@ -74,7 +79,7 @@ class BleRequestQueue(
                 }
             }
         } else if(!success){
-            Log.e("BLE", "Write execution failed immediately.")
+            logError("Write execution failed immediately.")
         }
         // IF WRITE WITHOUT RESPONSE -> LOOP IMMEDIATELY TO THE NEXT ITEM
     }
@@ -89,11 +94,26 @@ class BleRequestQueue(
         unlockSignal()
     }
     fun enqueueWrite(
-        characteristic: BluetoothGattCharacteristic,
+        charUuid: UUID,
         data: ByteArray,
-        writeType: Int = BluetoothGattCharacteristic.WRITE_TYPE_DEFAULT,
+        writeType: Int = BLEContract.WRITE_TYPE_DEFAULT,
         priority: Int = PRIORITY_LOW){
-        queue.add(BleOperation.Write(characteristic, data, writeType, priority))
+        queue.add(BleOperation.Write(charUuid, data, writeType, priority))
+    }
+
+    // LATEST-WINS WRITE -> DROPS ANY WRITE STILL PENDING FOR THE SAME CHARACTERISTIC (STREAMED SETPOINTS)
+    fun replaceWrite(
+        charUuid: UUID,
+        data: ByteArray,
+        writeType: Int = BLEContract.WRITE_TYPE_NO_RESPONSE,
+        priority: Int = PRIORITY_STREAM){
+        removeWrites(charUuid)
+        queue.add(BleOperation.Write(charUuid, data, writeType, priority))
+    }
+
+    // DROP EVERY WRITE STILL PENDING FOR A CHARACTERISTIC (QUEUED SETPOINTS WHEN THE STREAM ENDS)
+    fun removeWrites(charUuid: UUID){
+        queue.removeIf { it is BleOperation.Write && it.charUuid == charUuid }
     }
 
     fun onWriteComplete() {
@@ -109,16 +129,4 @@ class BleRequestQueue(
             }
         }
     }
-
-    @SuppressLint("MissingPermission")
-    private fun executeWrite(gatt: BluetoothGatt, op: BleOperation.Write): Boolean{
-        return if(Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU){
-            val result = gatt.writeCharacteristic(op.characteristic, op.payload, op.writeType)
-            result == BluetoothStatusCodes.SUCCESS
-        } else {
-            op.characteristic.writeType = op.writeType
-            op.characteristic.value = op.payload
-            gatt.writeCharacteristic(op.characteristic)
-        }
-    }
 }
\ No newline at end of file
@@ -0,0 +1,47 @@
+package com.remotemotorcontroller.ble
+
+import com.remotemotorcontroller.utils.readLe32
+
+sealed class BleState{
+    object Disconnected : BleState()
+    object Scanning : BleState()
+
+    data class Connecting (val name: String?) : BleState()
+
+    data class Connected(
+        val name: String?,
+        val telemetry: Telemetry? = null,  // CONTAINS the live RPM/Angle data
+        val streamed: Boolean = false      // telemetry IS THE NEWEST L2CAP STREAM SAMPLE (ALREADY IN BLEManager.stream)
+    ) : BleState()
+}
+
+// A SETPOINT COMMAND THAT WAS SENT -> MARKS THE START OF A STEP FOR THE ANALYTICS
+data class MotorCommand(val cmd: Byte, val value: Int)
+
+data class Telemetry(
+    val status: Int,
+    val rpm: Int,
+    val angle: Int,
+    val seq: Long? = null,      // DEVICE SAMPLE NUMBER (ONE PER CONTROL TICK) - NULL FOR 9 BYTE FIRMWARE
+    val timeMs: Long? = null    // DEVICE UPTIME WHEN THE SAMPLE WAS TAKEN
+){
+    companion object{   // USING COMPANION OBJECT for INIT TO BE ABLE TO RETURN NULL IF APPLICABLE
+        const val SIZE = 17     // [STATUS][SPEED][POSITION][SEQ][TIMESTAMP]
+
+        fun fromBytes(value: ByteArray, offset: Int = 0) : Telemetry? {
+            if(value.size - offset < 9) return null
+            val status = value[offset].toInt() and 0xFF
+            val speed = value.readLe32(offset + 1)
+            val position = value.readLe32(offset + 5)
+            if(value.size - offset < SIZE) return Telemetry(status, speed, position)
+
+            val seq = value.readLe32(offset + 9).toLong() and 0xFFFFFFFFL
+            val timeMs = value.readLe32(offset + 13).toLong() and 0xFFFFFFFFL
+            return Telemetry(status, speed, position, seq, timeMs)
+        }
+
+        // count BACK-TO-BACK SAMPLES STARTING AT offset (HISTORY NOTIFICATIONS, STREAM SDUs)
+        fun listFromBytes(value: ByteArray, offset: Int, count: Int): List<Telemetry> =
+            (0 until count).mapNotNull { i -> fromBytes(value, offset + i * SIZE) }
+    }
+}
@@ -0,0 +1,33 @@
+package com.remotemotorcontroller.ble
+
+
+// ENCODES AND QUEUES THE DISCRETE COMMANDS -> ONE PATH SHARED BY BLEManager AND THE LOOPBACK TESTS
+// onCommand PUBLISHES THE STEP TRIGGERS (SPEED / POSITION / SHUTDOWN) FOR THE ANALYTICS
+class MotorCommander(
+    private val queueProvider: () -> BleRequestQueue?,
+    private val onCommand: (MotorCommand) -> Unit = {}
+) {
+
+    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
+    fun setSpeed(rpm: Int) = send(BLEContract.CMD_SPEED, rpm, BleRequestQueue.PRIORITY_LOW, publish = true)
+
+    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
+    fun setPosition(pos: Int) = send(BLEContract.CMD_POSITION, pos, BleRequestQueue.PRIORITY_LOW, publish = true)
+
+    // LOW PRIORITY, DEFAULT (ACK) - USER REQUEST
+    fun calibrate() = send(BLEContract.CMD_CALIBRATE, 0, BleRequestQueue.PRIORITY_LOW, publish = false)
+
+    // CRITICAL PRIORITY, DEFAULT (ACK) - SAFETY CRITICAL (MUST HAPPEN NOW AND BE CONFIRMED)
+    fun shutdown() = send(BLEContract.CMD_SHUTDOWN, 0, BleRequestQueue.PRIORITY_CRITICAL, publish = true)
+
+    private fun send(cmd: Byte, value: Int, priority: Int, publish: Boolean){
+        val queue = queueProvider() ?: return
+        queue.enqueueWrite(
+            charUuid = BLEContract.CHAR_CMD,
+            data = BLEContract.commandPayload(cmd, value),
+            writeType = BLEContract.WRITE_TYPE_DEFAULT,
+            priority = priority
+        )
+        if(publish) onCommand(MotorCommand(cmd, value))
+    }
+}
@@ -0,0 +1,20 @@
+package com.remotemotorcontroller.ble
+
+import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.StateFlow
+import java.util.UUID
+
+// WHAT THE REQUEST QUEUE WRITES THROUGH -> GATT ON THE PHONE, AN IN-PROCESS SIMULATOR ON THE JVM
+interface MotorTransport {
+    // ISSUE ONE WRITE -> FALSE IF IT COULD NOT BE STARTED. A WRITE_TYPE_DEFAULT WRITE IS CONFIRMED LATER
+    // THROUGH BleRequestQueue.onWriteComplete()
+    fun write(charUuid: UUID, payload: ByteArray, writeType: Int): Boolean
+}
+
+// WHAT THE ANALYTICS CONSUME -> BLEManager ON THE PHONE, A LOOPBACK SOURCE ON THE JVM
+interface TelemetrySource {
+    val state: StateFlow<BleState>
+    val backfill: SharedFlow<List<Telemetry>>
+    val stream: SharedFlow<List<Telemetry>>
+    val commands: SharedFlow<MotorCommand>
+}
@@ -0,0 +1,15 @@
+package com.remotemotorcontroller.utils
+
+fun ByteArray.toHex(): String = joinToString(""){ "%02X".format(it.toInt() and 0xFF)}
+
+fun String.hexToBytesOrNull(): ByteArray? =
+    if(length % 2 == 0) runCatching{
+        chunked(2).map{it.toInt(16).toByte()}.toByteArray()
+    }.getOrNull() else null
+
+// READ A LITTLE-ENDIAN INT32 STARTING AT offset
+fun ByteArray.readLe32(offset: Int): Int =
+    (this[offset].toInt() and 0xFF) or
+            ((this[offset + 1].toInt() and 0xFF) shl 8) or
+            ((this[offset + 2].toInt() and 0xFF) shl 16) or
+            ((this[offset + 3].toInt() and 0xFF) shl 24)
@@ -0,0 +1,49 @@
+package com.remotemotorcontroller.loopback
+
+import com.remotemotorcontroller.ble.BleState
+import com.remotemotorcontroller.ble.MotorCommand
+import com.remotemotorcontroller.ble.Telemetry
+import com.remotemotorcontroller.ble.TelemetrySource
+import kotlinx.coroutines.flow.MutableSharedFlow
+import kotlinx.coroutines.flow.MutableStateFlow
+import kotlinx.coroutines.flow.SharedFlow
+import kotlinx.coroutines.flow.StateFlow
+import kotlinx.coroutines.flow.asSharedFlow
+import kotlinx.coroutines.flow.asStateFlow
+
+// WHAT BLEManager PUBLISHES, FED FROM THE SIMULATED MOTOR INSTEAD OF GATT CALLBACKS
+class LoopbackSource : TelemetrySource {
+
+    private val _state = MutableStateFlow<BleState>(BleState.Connected("loopback"))
+    override val state: StateFlow<BleState> = _state.asStateFlow()
+
+    private val _backfill = MutableSharedFlow<List<Telemetry>>(extraBufferCapacity = 64)
+    override val backfill: SharedFlow<List<Telemetry>> = _backfill.asSharedFlow()
+
+    private val _stream = MutableSharedFlow<List<Telemetry>>(extraBufferCapacity = 64)
+    override val stream: SharedFlow<List<Telemetry>> = _stream.asSharedFlow()
+
+    private val _commands = MutableSharedFlow<MotorCommand>(extraBufferCapacity = 16)
+    override val commands: SharedFlow<MotorCommand> = _commands.asSharedFlow()
+
+    // SAME DECODE AS THE TELEMETRY NOTIFICATION IN BLEManager.onCharacteristicChanged
+    fun onNotify(value: ByteArray){
+        val t = Telemetry.fromBytes(value) ?: return
+        _state.value = BleState.Connected("loopback", t)
+    }
+
+    // SAME DECODE AS BLEManager.handleHistory
+    fun onHistory(value: ByteArray){
+        val count = value.firstOrNull()?.toInt()?.and(0xFF) ?: return
+        if(count == 0) return
+        _backfill.tryEmit(Telemetry.listFromBytes(value, 1, count))
+    }
+
+    fun onStream(samples: List<Telemetry>){
+        _stream.tryEmit(samples)
+    }
+
+    fun onCommand(c: MotorCommand){
+        _commands.tryEmit(c)
+    }
+}
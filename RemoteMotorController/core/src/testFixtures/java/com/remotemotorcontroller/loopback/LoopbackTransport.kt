@@ -0,0 +1,34 @@
+package com.remotemotorcontroller.loopback
+
+import com.remotemotorcontroller.ble.BLEContract
+import com.remotemotorcontroller.ble.BleRequestQueue
+import com.remotemotorcontroller.ble.MotorTransport
+import com.remotemotorcontroller.utils.readLe32
+import java.util.UUID
+
+// IN-PROCESS STAND-IN FOR THE GATT LINK -> DECODES WRITES STRAIGHT INTO THE SIMULATED MOTOR.
+// ACKED WRITES ARE CONFIRMED IMMEDIATELY, SO THE QUEUE NEVER WAITS ON A RADIO
+class LoopbackTransport(
+    private val motor: SimulatedMotor,
+    private val queueProvider: () -> BleRequestQueue?
+) : MotorTransport {
+
+    override fun write(charUuid: UUID, payload: ByteArray, writeType: Int): Boolean {
+        val ok = when(charUuid){
+            BLEContract.CHAR_CMD ->
+                payload.size >= 5 && motor.onCommand(payload[0], payload.readLe32(1))
+            BLEContract.CHAR_SETPOINT ->
+                payload.size >= 7 && motor.onCommand(payload[0], payload.readLe32(3))
+            BLEContract.CHAR_HISTORY ->
+                (payload.size >= 4).also { if(it) motor.onHistoryRequest(payload.readLe32(0).toLong() and 0xFFFFFFFFL) }
+            BLEContract.CHAR_HEARTBEAT -> true
+            else -> false
+        }
+        if(!ok) return false
+
+        if(writeType == BLEContract.WRITE_TYPE_DEFAULT){
+            queueProvider()?.onWriteComplete()
+        }
+        return true
+    }
+}
@@ -0,0 +1,193 @@
+package com.remotemotorcontroller.loopback
+
+import com.remotemotorcontroller.ble.BLEContract
+
+// JVM PORT OF firmware/src/simulation/motor_sim.c + motor.c -> SAME INTEGER PHYSICS, SAME 17 BYTE TELEMETRY.
+// TICKS ARE DRIVEN BY THE TEST INSTEAD OF A 15 ms THREAD SO RUNS ARE DETERMINISTIC; DEVICE TIME ADVANCES
+// BY ONE PERIOD PER TICK. STREAMED SETPOINTS ARE APPLIED DIRECTLY (NO FIRMWARE INTERPOLATION).
+// EVERY TICK IS ALSO LOGGED LIKE telemetry_log.c SO HISTORY REQUESTS CAN BE ANSWERED, PACKED FOR mtu
+class SimulatedMotor(
+    private val onTelemetry: (ByteArray) -> Unit = {},
+    private val onHistory: (ByteArray) -> Unit = {},
+    private val mtu: Int = BLEContract.ATT_MTU_DEFAULT
+) {
+
+    companion object{
+        const val PERIOD_MS = 15
+
+        const val RPM_MAX = 6000
+        const val RPM_MIN = -6000
+
+        const val STATE_STOPPED = 0x00
+        const val STATE_RUNNING_SPEED = 0x01
+        const val STATE_RUNNING_POS = 0x02
+        const val STATE_MASK = 0x0F
+        const val FLAG_CMD_ACK = 0x80
+
+        const val LOG_DEPTH = 1024          // TELEMETRY_LOG_DEPTH
+    }
+
+    var status = STATE_STOPPED
+        private set
+    var speed = 0
+        private set
+    var position = 0
+        private set
+    var targetState = STATE_STOPPED
+        private set
+    var targetSpeed = 0
+        private set
+    var targetPosition = 0
+        private set
+
+    private var seq = 0L
+    private var timeMs = 0L
+    private var cmdAcks = 0             // motor_ack_command() COUNT -> LOW BIT IS MOTOR_FLAG_CMD_ACK
+    private var ackFlag = 0             // motor_latch_command_ack() -> LATCHED AT THE START OF EACH TICK
+    private var lastFullStatus = 0      // STATUS BYTE OF THE PREVIOUS TICK (motor_loop's prev_status)
+    private val log = ArrayDeque<ByteArray>()
+
+    // HISTORY REQUESTS FULLY ANSWERED (THE count == 0 TERMINATOR WAS SENT)
+    @Volatile var historyServed = 0
+        private set
+
+    // CMD CHARACTERISTIC -> SAME DECODE AS write_motor() IN bluetooth.c
+    @Synchronized
+    fun onCommand(cmd: Byte, value: Int): Boolean {
+        when(cmd){
+            BLEContract.CMD_SPEED -> {
+                targetState = STATE_RUNNING_SPEED
+                targetSpeed = value.coerceIn(RPM_MIN, RPM_MAX)
+            }
+            BLEContract.CMD_POSITION -> {
+                targetState = STATE_RUNNING_POS
+                targetPosition = Math.floorMod(value, 360)
+            }
+            BLEContract.CMD_CALIBRATE -> {
+                status = STATE_STOPPED
+                speed = 0
+                position = 0
+                targetState = STATE_STOPPED
+                targetSpeed = 0
+                targetPosition = 0
+            }
+            BLEContract.CMD_SHUTDOWN -> {
+                targetState = STATE_STOPPED
+                targetSpeed = 0
+            }
+            else -> return false
+        }
+        cmdAcks++
+        return true
+    }
+
+    // ONE CONTROL TICK -> motor_backend_update() IN motor_sim.c
+    @Synchronized
+    fun tick(){
+        ackFlag = if(cmdAcks and 1 == 1) FLAG_CMD_ACK else 0
+        var currPos = position
+        var currSpeed = speed
+        val prevPos = position
+        val prevSpeed = speed
+
+        when(targetState){
+            STATE_RUNNING_SPEED -> {
+                setState(STATE_RUNNING_SPEED)
+                val dt = smallStepSigned(targetSpeed - currSpeed, 0.2f)
+                if(dt != 0) currSpeed = clampSpeed(currSpeed + dt)
+                if(currSpeed != 0) currPos = normalizeAngle(currPos + currSpeed / 12)
+            }
+            STATE_RUNNING_POS -> {
+                setState(STATE_RUNNING_POS)
+                var error = targetPosition - currPos
+                if(error > 180) error -= 360
+                if(error < -180) error += 360
+
+                if(error == 0){
+                    currSpeed = 0
+                    setState(STATE_STOPPED)
+                } else {
+                    currSpeed = clampSpeed(error * 3)
+                    val dt = smallStepSigned(currSpeed, 0.4f)
+                    if(dt != 0) currPos = normalizeAngle(currPos + dt)
+                }
+            }
+            else -> {   // STOPPED / ESTOP -> DECAY SPEED TOWARDS 0
+                currSpeed = when {
+                    currSpeed > 0 -> maxOf(currSpeed - 25, 0)
+                    currSpeed < 0 -> minOf(currSpeed + 25, 0)
+                    else -> 0
+                }
+                setState(STATE_STOPPED)
+            }
+        }
+
+        speed = currSpeed
+        position = currPos
+        seq++
+        timeMs += PERIOD_MS
+
+        log.addLast(pack())
+        if(log.size > LOG_DEPTH) log.removeFirst()
+
+        val full = fullStatus()
+        val statusChanged = full != lastFullStatus
+        lastFullStatus = full
+
+        if(position != prevPos || speed != prevSpeed || statusChanged){
+            onTelemetry(pack())
+        }
+    }
+
+    // HISTORY CHARACTERISTIC -> write_history() + history_work_fn(): EVERY LOGGED SAMPLE FROM fromSeq UP TO
+    // THE NEWEST, AS [COUNT][COUNT x 17] NOTIFICATIONS FOLLOWED BY A count == 0 TERMINATOR
+    @Synchronized
+    fun onHistoryRequest(fromSeq: Long){
+        val oldest = seq - log.size + 1
+        val samples = log.drop((fromSeq - oldest).coerceIn(0, log.size.toLong()).toInt())
+
+        for(chunk in samples.chunked(BLEContract.historySamplesPerPdu(mtu))){
+            val pdu = ByteArray(1 + chunk.size * 17)
+            pdu[0] = chunk.size.toByte()
+            chunk.forEachIndexed { i, sample -> sample.copyInto(pdu, 1 + i * 17) }
+            onHistory(pdu)
+        }
+        onHistory(byteArrayOf(0))
+        historyServed++
+    }
+
+    // [STATUS][SPEED le32][POSITION le32][SEQ le32][TIMESTAMP le32] -> telemetry_sample_pack()
+    @Synchronized
+    fun pack(): ByteArray {
+        val out = ByteArray(17)
+        out[0] = fullStatus().toByte()
+        putLe32(out, 1, speed)
+        putLe32(out, 5, position)
+        putLe32(out, 9, seq.toInt())
+        putLe32(out, 13, timeMs.toInt())
+        return out
+    }
+
+    private fun fullStatus(): Int = status or ackFlag
+
+    private fun setState(state: Int){
+        status = (status and STATE_MASK.inv()) or (state and STATE_MASK)
+    }
+
+    private fun smallStepSigned(value: Int, factor: Float): Int {
+        val step = (value * factor).toInt()
+        if(step == 0) return Integer.signum(value)
+        return step
+    }
+
+    private fun normalizeAngle(a: Int): Int = Math.floorMod(a, 360)
+
+    private fun clampSpeed(s: Int): Int = s.coerceIn(RPM_MIN, RPM_MAX)
+
+    private fun putLe32(out: ByteArray, offset: Int, v: Int){
+        out[offset] = (v and 0xFF).toByte()
+        out[offset + 1] = ((v shr 8) and 0xFF).toByte()
+        out[offset + 2] = ((v shr 16) and 0xFF).toByte()
+        out[offset + 3] = ((v shr 24) and 0xFF).toByte()
+    }
+}
@@ -23,3 +23,5 @@ dependencyResolutionManagement {
 
 rootProject.name = "Remote Motor Controller"
 include(":app")
+include(":core")        // PLAIN JVM BLE PIPELINE (PROTOCOL, REQUEST QUEUE, STEP ANALYZER) + LOOPBACK TEST FIXTURES
+include(":benchmark")   // JMH BENCHMARKS OVER :core -> ./gradlew :benchmark:benchmark
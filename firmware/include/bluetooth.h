@@ -26,6 +26,14 @@
 #define BT_UUID_MOTOR_HEARTBEAT_VAL \
 	BT_UUID_128_ENCODE(0x2215d558, 0xc569, 0x4bd1, 0x8947, 0xb4fd5f9432a0)
 
+// TELEMETRY HISTORY (BACKFILL) UUID
+#define BT_UUID_MOTOR_HISTORY_VAL \
+	BT_UUID_128_ENCODE(0x6a3e0c2f, 0x8b1d, 0x4f5a, 0x9c47, 0x2e81d05b7a13)
+
+// STREAMED SETPOINT (TELEOPERATION) UUID
+#define BT_UUID_MOTOR_SETPOINT_VAL \
+	BT_UUID_128_ENCODE(0x9f4b7d21, 0x3c6e, 0x4a88, 0xb5d2, 0x71e0c3a95f64)
+
 
 enum motor_cmds{
 	MOTOR_MODE_OFF = 0x00,
@@ -41,6 +49,9 @@ struct motor_app_ctx{
 	
 	// HEARTBEAT VALUE -> CONFIRMS BLE SYNCHRONIZATION
 	uint8_t heartbeat_val;
+
+	// FLAG TO INDICATE IF THE APP SUBSCRIBED TO THE HISTORY (BACKFILL) CHARACTERISTIC
+	bool history_enabled;
 };
 
 // PUBLIC API GETTERS FOR BLUETOOTH STATS
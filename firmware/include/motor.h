@@ -22,6 +22,7 @@
 // UPPER NIBBLE: DIAGNOSTIC FLAGS (BITS 4-7) - CHECK IF THERE ARE ANY WARNINGS/ISSUES REGARDING THE MOTOR
 #define MOTOR_FLAG_SYNC_BAD			0x10	// 0001 0000 
 #define MOTOR_FLAG_OVERHEAT			0x20	// 0010 0000
+#define MOTOR_FLAG_CMD_ACK			0x80	// 1000 0000 - TOGGLES ON EVERY ACCEPTED COMMAND (SEE motor_ack_command)
 
 #define MOTOR_FLAG_MASK				0xF0	// 1111 0000 - ISOLATE FLAGS
 
@@ -65,6 +66,18 @@ void motor_set_flag(uint8_t flag, bool active);
 void motor_set_sync_warning(bool active);
 void motor_set_overheat_warning(bool active);
 
+/**
+ * @brief Flip MOTOR_FLAG_CMD_ACK - call after a command's setpoint is written, so the first
+ *        telemetry sample carrying the new value is the first tick that ran on the new setpoint
+ */
+void motor_ack_command(void);
+
+/**
+ * @brief Latch the ack for this tick's telemetry - call before the backend reads the targets, so a
+ *        command landing mid-tick only shows up in the next tick's samples (never on one that ran the old setpoint)
+ */
+void motor_latch_command_ack(void);
+
 // TARGETED SETTERS
 /** @brief SET THE TARGETED/DESIRED MOTOR STATE - ONLY THE LOWER NIBBLES (NO FLAGS)*/
 void motor_set_target_state(uint8_t new_state);
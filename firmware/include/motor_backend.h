@@ -0,0 +1,18 @@
+#ifndef MOTOR_BACKEND_H_
+#define MOTOR_BACKEND_H_
+
+// MOTOR BACKEND OPS -> EXACTLY ONE BACKEND IS BUILT (CONFIG_APP_MOTOR_BACKEND_*), SO THE CONTROL LOOP
+// CALLS THESE DIRECTLY WITH NO FUNCTION POINTER ON THE TICK
+//   SIM       src/simulation/motor_sim.c   (NO HARDWARE)
+//   PWM_QDEC  src/motor/motor_pwm_qdec.c   (PWM DRIVE + QUADRATURE ENCODER FROM DEVICETREE)
+
+/** @brief Bring up the backend - returns 0 or a negative errno if its hardware is missing */
+int motor_backend_init(void);
+
+/**
+ * @brief Run one control tick - read the motor, drive it towards the motor API targets
+ * and write the measured speed/position/state back through the motor API
+ */
+void motor_backend_update(void);
+
+#endif /* MOTOR_BACKEND_H_ */
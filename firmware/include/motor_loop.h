@@ -0,0 +1,7 @@
+#ifndef MOTOR_LOOP_H_
+#define MOTOR_LOOP_H_
+
+/** @brief Start the control thread - one motor_backend_update() every CONFIG_APP_MOTOR_TICK_MS */
+void motor_loop_init(void);
+
+#endif /* MOTOR_LOOP_H_ */
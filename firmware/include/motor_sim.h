@@ -1,7 +0,0 @@
-#ifndef MOTOR_SIM_H_
-#define MOTOR_SIM_H_
-
-/** @brief Initialize and start the motor simulation thread */
-void motor_sim_init(void);
-
-#endif /* MOTOR_SIM_H_ */
\ No newline at end of file
@@ -0,0 +1,41 @@
+#ifndef TELEMETRY_LOG_H_
+#define TELEMETRY_LOG_H_
+
+#include <zephyr/types.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// NUMBER OF PER-TICK SAMPLES KEPT IN RAM (POWER OF TWO) -> ~15 SECONDS AT THE 15 MS SIM TICK
+#define TELEMETRY_LOG_DEPTH		1024
+
+// SIZE OF ONE SAMPLE ON THE WIRE
+// [STATUS (1 BYTE)] [SPEED (4 BYTES)] [POSITION (4 BYTES)] [SEQ (4 BYTES)] [TIMESTAMP MS (4 BYTES)]
+#define TELEMETRY_SAMPLE_LEN	17
+
+struct telemetry_sample{
+	uint32_t seq;			// MONOTONIC SAMPLE NUMBER (ONE PER CONTROL TICK)
+	uint32_t timestamp_ms;	// DEVICE UPTIME WHEN THE SAMPLE WAS TAKEN
+	uint8_t status;
+	int32_t speed;
+	int32_t position;
+};
+
+/** @brief Clear the history ring and restart the sequence counter */
+void telemetry_log_init(void);
+
+/** @brief Snapshot the motor API into the ring (call once per control tick) - returns the sample's seq */
+uint32_t telemetry_log_record(void);
+
+/** @brief Copy the newest sample - returns false if nothing was recorded yet */
+bool telemetry_log_latest(struct telemetry_sample *out);
+
+/**
+ * @brief Copy up to max samples starting at from_seq (or the oldest sample still held
+ * if from_seq was already overwritten) - returns the number of samples copied
+ */
+size_t telemetry_log_read(uint32_t from_seq, struct telemetry_sample *out, size_t max);
+
+/** @brief Serialize a sample to the little-endian wire format (TELEMETRY_SAMPLE_LEN bytes) */
+void telemetry_sample_pack(const struct telemetry_sample *s, uint8_t out[TELEMETRY_SAMPLE_LEN]);
+
+#endif /* TELEMETRY_LOG_H_ */
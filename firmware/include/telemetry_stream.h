@@ -0,0 +1,28 @@
+#ifndef TELEMETRY_STREAM_H_
+#define TELEMETRY_STREAM_H_
+
+#include <zephyr/kernel.h>
+
+// SDU = [COUNT (2 BYTES)] [COUNT x SAMPLE (TELEMETRY_SAMPLE_LEN BYTES)]
+#define TELEMETRY_STREAM_HDR_LEN 2
+
+#if defined(CONFIG_APP_TELEMETRY_STREAM)
+
+/** @brief Register the L2CAP CoC server (call once Bluetooth is ready) */
+void telemetry_stream_init(void);
+
+/** @brief Queue the newest history sample for streaming (call once per control tick) */
+void telemetry_stream_push_latest(void);
+
+/** @brief Check if the app has an open stream channel */
+bool telemetry_stream_is_connected(void);
+
+#else
+
+static inline void telemetry_stream_init(void) {}
+static inline void telemetry_stream_push_latest(void) {}
+static inline bool telemetry_stream_is_connected(void) { return false; }
+
+#endif /* CONFIG_APP_TELEMETRY_STREAM */
+
+#endif /* TELEMETRY_STREAM_H_ */
@@ -0,0 +1,34 @@
+#ifndef TELEOP_H_
+#define TELEOP_H_
+
+#include <zephyr/types.h>
+#include <stdbool.h>
+
+// STREAMED SETPOINT WRITE (WRITE WITHOUT RESPONSE)
+// [MODE (1 BYTE)] [SEQ (2 BYTES)] [VALUE (4 BYTES)] -> MODE IS MOTOR_MODE_SPEED OR MOTOR_MODE_POSITION
+#define TELEOP_SETPOINT_LEN		7
+
+// NO SETPOINT FOR THIS LONG -> STREAM IS CONSIDERED STALLED AND THE MOTOR DECELERATES TO A STOP
+#define TELEOP_STALL_MS			200
+
+// EXTRAPOLATE PAST THE NEWEST SETPOINT BY AT MOST THIS FRACTION OF THE UPDATE INTERVAL (PERCENT)
+#define TELEOP_EXTRAPOLATE_PCT	50
+
+/**
+ * @brief Feed a streamed setpoint - returns false if it was out of order / stale and discarded
+ */
+bool teleop_on_setpoint(uint8_t mode, uint16_t seq, int32_t value);
+
+/** @brief Run once per control tick - writes the interpolated target into the motor API */
+void teleop_tick(void);
+
+/**
+ * @brief Leave teleoperation (a discrete command took over) - the last seq is kept,
+ *        so only a newer setpoint can start the stream again
+ */
+void teleop_stop(void);
+
+/** @brief Forget the stream and its seq (connection closed, the next client starts over) */
+void teleop_reset(void);
+
+#endif /* TELEOP_H_ */
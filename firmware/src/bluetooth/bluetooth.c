@@ -12,6 +12,9 @@
 #include "bluetooth.h"
 #include "watchdog.h"
 #include "motor.h"
+#include "telemetry_log.h"
+#include "telemetry_stream.h"
+#include "teleop.h"
 
 LOG_MODULE_REGISTER(bluetooth, LOG_LEVEL_INF);
 
@@ -36,6 +39,19 @@ static struct bt_uuid_128 heartbeat_char_uuid = BT_UUID_INIT_128(BT_UUID_MOTOR_H
 // MOTOR TELEMETRY CHARACTERISTIC
 static struct bt_uuid_128 motor_telemetry_char_uuid = BT_UUID_INIT_128(BT_UUID_MOTOR_TELEMETRY_VAL);
 
+// TELEMETRY HISTORY (BACKFILL) CHARACTERISTIC
+static struct bt_uuid_128 history_char_uuid = BT_UUID_INIT_128(BT_UUID_MOTOR_HISTORY_VAL);
+
+// STREAMED SETPOINT CHARACTERISTIC
+static struct bt_uuid_128 setpoint_char_uuid = BT_UUID_INIT_128(BT_UUID_MOTOR_SETPOINT_VAL);
+
+// BACKFILL STREAM STATE -> RUNS ON THE SYSTEM WORKQUEUE, NOT IN THE WRITE CALLBACK
+#define HISTORY_RETRY_MS 5
+static struct k_work_delayable history_work;
+static struct bt_conn *history_conn;
+static uint32_t history_next_seq;	// NEXT SEQ TO SEND
+static uint32_t history_end_seq;	// STOP BEFORE THIS SEQ (NEWEST SAMPLE AT REQUEST TIME + 1)
+
 
 void watchdog_kick(void);
 
@@ -44,6 +60,7 @@ static uint8_t msd[2 + 6]; // MANUFACTURER SPECIFIC DATA; 2 BYTES COMPANY ID + 6
 
 // FORWARD DECLARATIONS
 void motor_notify_telemetry(void);
+static void history_stop(void);
 
 
 static void build_ids(void){
@@ -76,6 +93,8 @@ static ssize_t write_motor(struct bt_conn *conn,
 	uint8_t cmd = data[0];
 	int32_t val = (int32_t) sys_get_le32(&data[1]); // 4 BYTES FOR VALUE - payload
 
+	// A DISCRETE COMMAND TAKES OVER FROM ANY SETPOINT STREAM
+	teleop_stop();
 
 	// DETERMINE THE NEW STATE OF THE MOTOR
 	switch(cmd){
@@ -102,6 +121,9 @@ static ssize_t write_motor(struct bt_conn *conn,
 			return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
 	}
 
+	// THE APP STARTS STEP METRICS AT THE FIRST SAMPLE WITH THE FLIPPED BIT, NOT WHEN IT SENT THE WRITE
+	motor_ack_command();
+
 	return len;
 }
 
@@ -150,12 +172,78 @@ static ssize_t write_heartbeat(struct bt_conn *conn,
 }
 
 
+// WRITE TO SETPOINT (WITHOUT RESPONSE) -> [MODE (1 BYTE)] [SEQ (2 BYTES)] [VALUE (4 BYTES)]
+// STALE / OUT OF ORDER PACKETS ARE DROPPED SILENTLY, THE CONTROL TICK INTERPOLATES BETWEEN THE REST
+static ssize_t write_setpoint(struct bt_conn *conn,
+			   const struct bt_gatt_attr *attr,
+			   const void *buf, uint16_t len,
+			   uint16_t offset, uint8_t flags)
+{
+	if(offset != 0) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+	if(len < TELEOP_SETPOINT_LEN) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+
+	const uint8_t *data = buf;
+	uint8_t mode = data[0];
+	uint16_t seq = sys_get_le16(&data[1]);
+	int32_t val = (int32_t) sys_get_le32(&data[3]);
+
+	if(mode != MOTOR_MODE_SPEED && mode != MOTOR_MODE_POSITION) {
+		LOG_WRN("UNKNOWN SETPOINT MODE: 0x%02X", mode);
+		return BT_GATT_ERR(BT_ATT_ERR_VALUE_NOT_ALLOWED);
+	}
+
+	teleop_on_setpoint(mode, seq, val);
+	return len;
+}
+
+// WRITE TO HISTORY -> [FROM_SEQ (4 BYTES)] STARTS STREAMING EVERY SAMPLE FROM FROM_SEQ UP TO THE NEWEST
+static ssize_t write_history(struct bt_conn *conn,
+			   const struct bt_gatt_attr *attr,
+			   const void *buf, uint16_t len,
+			   uint16_t offset, uint8_t flags)
+{
+	if(offset != 0) {
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_OFFSET);
+	}
+	if(len < 4) { // MINIMUM 4 BYTES REQUIRED
+		return BT_GATT_ERR(BT_ATT_ERR_INVALID_ATTRIBUTE_LEN);
+	}
+	if(!motor_ctx.history_enabled) {
+		return BT_GATT_ERR(BT_ATT_ERR_CCC_IMPROPER_CONF);
+	}
+
+	struct telemetry_sample latest;
+	if(!telemetry_log_latest(&latest)) {
+		latest.seq = 0;
+	}
+
+	// RESTART ANY STREAM ALREADY IN PROGRESS
+	history_stop();
+	history_conn = bt_conn_ref(conn);
+	history_next_seq = sys_get_le32(buf);
+	history_end_seq = latest.seq + 1;
+
+	LOG_INF("Backfill requested from seq %u to %u", history_next_seq, latest.seq);
+	k_work_reschedule(&history_work, K_NO_WAIT);
+
+	return len;
+}
+
 // CALLBACK FOR CLIENT CHARACTERISTIC CONFIGURATION (CCC) CHANGES
 static void motor_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value){
 	motor_ctx.notification_enabled = (value == BT_GATT_CCC_NOTIFY);
 	LOG_INF("Notifications %s", motor_ctx.notification_enabled ? "enabled" : "disabled");
 }
 
+static void history_ccc_cfg_changed(const struct bt_gatt_attr *attr, uint16_t value){
+	motor_ctx.history_enabled = (value == BT_GATT_CCC_NOTIFY);
+	LOG_INF("History notifications %s", motor_ctx.history_enabled ? "enabled" : "disabled");
+}
+
 // DEFINE GATT CHARACTERISTICS AND SERVICES
 // DEFINE THE motor_svc SERVICE
 BT_GATT_SERVICE_DEFINE(motor_svc, BT_GATT_PRIMARY_SERVICE(&motor_srv_uuid),
@@ -179,15 +267,101 @@ BT_GATT_SERVICE_DEFINE(motor_svc, BT_GATT_PRIMARY_SERVICE(&motor_srv_uuid),
 			       NULL, NULL, NULL),   
 	// CLIENT CHARACTERISTIC CONFIGURATION (CCC) - FOR ENABLING/DISABLING NOTIFICATIONS
 	BT_GATT_CCC(motor_ccc_cfg_changed,
-		    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE)
+		    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+	// TELEMETRY HISTORY CHARACTERISTIC - WRITE THE START SEQ, SAMPLES COME BACK AS NOTIFICATIONS
+	BT_GATT_CHARACTERISTIC(&history_char_uuid.uuid,
+				   BT_GATT_CHRC_WRITE | BT_GATT_CHRC_NOTIFY,
+			       BT_GATT_PERM_WRITE,
+			       NULL, write_history, NULL),
+	BT_GATT_CCC(history_ccc_cfg_changed,
+		    BT_GATT_PERM_READ | BT_GATT_PERM_WRITE),
+	// STREAMED SETPOINT CHARACTERISTIC - WRITE WITHOUT RESPONSE AT A FIXED RATE
+	BT_GATT_CHARACTERISTIC(&setpoint_char_uuid.uuid,
+				   BT_GATT_CHRC_WRITE_WITHOUT_RESP,
+			       BT_GATT_PERM_WRITE,
+			       NULL, write_setpoint, NULL)
 );
 
-// MERGED_BYTE (1 BYTE) = 
-// [MERGED_BYTE (1 BYTE)] [SPEED (4 BYTES)] [POSITION (4 BYTES)] = 9 BYTES TOTAL
-static inline void pack_telemetry(uint8_t out[9]){
-	out[0] = motor_get_full_status();
-	sys_put_le32(motor_get_speed(), &out[1]);
-	sys_put_le32(motor_get_position(), &out[5]);
+// [STATUS (1 BYTE)] [SPEED (4 BYTES)] [POSITION (4 BYTES)] [SEQ (4 BYTES)] [TIMESTAMP (4 BYTES)] = 17 BYTES TOTAL
+// THE FIRST 9 BYTES ARE THE ORIGINAL FORMAT, SEQ/TIMESTAMP COME FROM THE HISTORY RING
+static inline void pack_telemetry(uint8_t out[TELEMETRY_SAMPLE_LEN]){
+	struct telemetry_sample s;
+	if(!telemetry_log_latest(&s)){
+		s = (struct telemetry_sample){
+			.status = motor_get_full_status(),
+			.speed = motor_get_speed(),
+			.position = motor_get_position(),
+		};
+	}
+	telemetry_sample_pack(&s, out);
+}
+
+// HISTORY NOTIFICATION = [COUNT (1 BYTE)] [COUNT x SAMPLE (17 BYTES)], COUNT == 0 MARKS THE END OF THE BACKFILL
+#define HISTORY_MAX_PER_PDU 14	// 1 + 14 * 17 = 239 BYTES -> FITS THE LARGEST LE DATA LENGTH
+
+// DROP THE STREAM'S CONNECTION REF -> ONLY FROM history_work_fn ITSELF OR ONCE THE WORK IS CANCELLED
+static void history_release(void){
+	if(history_conn){
+		bt_conn_unref(history_conn);
+		history_conn = NULL;
+	}
+}
+
+// FROM BT CALLBACKS -> WAIT FOR A RUNNING history_work_fn TO RETURN BEFORE UNREFFING THE CONN IT IS USING.
+// NEVER FROM history_work_fn (WAITING ON ITSELF WOULD DEADLOCK THE WORKQUEUE)
+static void history_stop(void){
+	struct k_work_sync sync;
+
+	k_work_cancel_delayable_sync(&history_work, &sync);
+	history_release();
+}
+
+static void history_work_fn(struct k_work *work){
+	if(!history_conn || !motor_ctx.history_enabled){
+		history_release();
+		return;
+	}
+
+	// PACK AS MANY SAMPLES AS THE NEGOTIATED MTU ALLOWS (ATT HEADER IS 3 BYTES)
+	size_t per_pdu = (bt_gatt_get_mtu(history_conn) - 3 - 1) / TELEMETRY_SAMPLE_LEN;
+	if(per_pdu > HISTORY_MAX_PER_PDU) per_pdu = HISTORY_MAX_PER_PDU;
+	if(per_pdu == 0) per_pdu = 1;	// DEFAULT 23 BYTE MTU STILL FITS ONE SAMPLE
+
+	struct telemetry_sample samples[HISTORY_MAX_PER_PDU];
+	uint8_t pdu[1 + HISTORY_MAX_PER_PDU * TELEMETRY_SAMPLE_LEN];
+
+	while(true){
+		size_t want = (history_next_seq < history_end_seq) ? history_end_seq - history_next_seq : 0;
+		if(want > per_pdu) want = per_pdu;
+
+		size_t n = (want > 0) ? telemetry_log_read(history_next_seq, samples, want) : 0;
+
+		pdu[0] = (uint8_t)n;
+		for(size_t i = 0; i < n; i++){
+			telemetry_sample_pack(&samples[i], &pdu[1 + i * TELEMETRY_SAMPLE_LEN]);
+		}
+
+		int err = bt_gatt_notify(history_conn, &motor_svc.attrs[9],
+					 pdu, 1 + n * TELEMETRY_SAMPLE_LEN);
+		if(err == -ENOMEM){
+			// TX BUFFERS FULL -> TRY AGAIN SHORTLY WITHOUT BLOCKING THE WORKQUEUE
+			k_work_reschedule(&history_work, K_MSEC(HISTORY_RETRY_MS));
+			return;
+		}
+		if(err){
+			LOG_ERR("Failed to send history (err %d)", err);
+			history_release();
+			return;
+		}
+		if(n == 0){
+			LOG_INF("Backfill complete");
+			history_release();
+			return;
+		}
+
+		// SAMPLES OLDER THAN THE RING ARE SKIPPED -> CONTINUE AFTER THE LAST ONE ACTUALLY SENT
+		history_next_seq = samples[n - 1].seq + 1;
+	}
 }
 
 // HELPER TO SEND TELEMETRY NOTIFICATIONS TO PHONE => BROADCAST TO ALL CONNECTED DEVICES
@@ -203,12 +377,17 @@ void motor_notify_telemetry(void)
 	 * [5] CHAR DECLAR. (TELEMETRY)
 	 * [6] CHAR VAL. (TELEMETRY)
 	 * [7] CCC
+	 * [8] CHAR DECLAR. (HISTORY)
+	 * [9] CHAR VAL. (HISTORY)
+	 * [10] CCC
+	 * [11] CHAR DECLAR. (SETPOINT)
+	 * [12] CHAR VAL. (SETPOINT)
 	 */
 	if (!motor_ctx.notification_enabled) {
 		return;
 	}
 
-	uint8_t telemetry_data[9];
+	uint8_t telemetry_data[TELEMETRY_SAMPLE_LEN];
 	pack_telemetry(telemetry_data);
 
 	// SEND NOTIFICATION
@@ -230,6 +409,10 @@ void bt_ready(int err)
 	}
 	motor_ctx.heartbeat_val = 0;
 	motor_ctx.notification_enabled = false;
+	motor_ctx.history_enabled = false;
+	k_work_init_delayable(&history_work, history_work_fn);
+
+	telemetry_stream_init();
 
 	LOG_INF("Bluetooth initialized");
 
@@ -276,6 +459,8 @@ static void disconnected(struct bt_conn *conn, uint8_t reason)
 {
 	LOG_INF("Disconnected (reason %u)", reason);
 	watchdog_stop();
+	history_stop();
+	teleop_reset();
 	motor_set_target_speed(0);
 }
 
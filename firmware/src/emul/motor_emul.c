@@ -0,0 +1,196 @@
+// EMULATED MOTOR FOR native_sim -> LETS THE PWM + QDEC BACKEND RUN CLOSED LOOP WITHOUT HARDWARE
+//   app,motor-emul-pwm   PWM CONTROLLER, CHANNEL 0 = FORWARD, CHANNEL 1 = REVERSE (H-BRIDGE IN1/IN2),
+//                        BOTH HIGH = BRAKE, BOTH LOW = COAST
+//   app,motor-emul-qdec  QDEC-STYLE SENSOR: A FIRST-ORDER MOTOR MODEL DRIVEN BY THE EMULATED PWM DUTY,
+//                        INTEGRATED UP TO EACH SAMPLE FETCH (SENSOR_CHAN_ROTATION + SENSOR_CHAN_RPM,
+//                        no-rpm HIDES THE LATTER LIKE THE nRF / STM32 QDEC DRIVERS, relative-rotation REPORTS THE
+//                        ROTATION SINCE THE PREVIOUS FETCH LIKE qdec_nrfx). A RELEASED DRIVE COASTS WITH
+//                        coast-time-constant-ms (INERTIA), DRIVEN OR BRAKED IT FOLLOWS time-constant-ms
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(motor_emul, LOG_LEVEL_INF);
+
+#define MOTOR_EMUL_PWM_CHANNELS	2
+#define MOTOR_EMUL_MAX_STEP_MS	1000	// CAP ON ONE INTEGRATION (FIRST FETCH / LONG PAUSES)
+
+// --- PWM ---
+#define DT_DRV_COMPAT app_motor_emul_pwm
+
+struct motor_emul_pwm_data{
+	uint32_t period[MOTOR_EMUL_PWM_CHANNELS];
+	uint32_t pulse[MOTOR_EMUL_PWM_CHANNELS];
+};
+
+static int motor_emul_pwm_set_cycles(const struct device *dev, uint32_t channel,
+				     uint32_t period_cycles, uint32_t pulse_cycles,
+				     pwm_flags_t flags)
+{
+	struct motor_emul_pwm_data *data = dev->data;
+
+	if(channel >= MOTOR_EMUL_PWM_CHANNELS || pulse_cycles > period_cycles){
+		return -EINVAL;
+	}
+	if(flags & PWM_POLARITY_INVERTED){
+		pulse_cycles = period_cycles - pulse_cycles;
+	}
+
+	data->period[channel] = period_cycles;
+	data->pulse[channel] = pulse_cycles;
+	return 0;
+}
+
+static int motor_emul_pwm_get_cycles_per_sec(const struct device *dev, uint32_t channel,
+					     uint64_t *cycles)
+{
+	ARG_UNUSED(dev);
+	ARG_UNUSED(channel);
+
+	*cycles = NSEC_PER_SEC;	// ONE CYCLE = ONE NS
+	return 0;
+}
+
+static DEVICE_API(pwm, motor_emul_pwm_api) = {
+	.set_cycles = motor_emul_pwm_set_cycles,
+	.get_cycles_per_sec = motor_emul_pwm_get_cycles_per_sec,
+};
+
+// NET DRIVE IN PERMILLE -> FORWARD DUTY MINUS REVERSE DUTY
+static int32_t motor_emul_pwm_drive(const struct device *dev)
+{
+	const struct motor_emul_pwm_data *data = dev->data;
+	int32_t duty[MOTOR_EMUL_PWM_CHANNELS] = {0};
+
+	for(int ch = 0; ch < MOTOR_EMUL_PWM_CHANNELS; ch++){
+		if(data->period[ch] > 0){
+			duty[ch] = (int32_t)(((uint64_t)data->pulse[ch] * 1000) / data->period[ch]);
+		}
+	}
+	return duty[0] - duty[1];
+}
+
+// BOTH CHANNELS LOW -> NO CURRENT PATH THROUGH THE WINDING, ONLY FRICTION SLOWS THE MOTOR
+static bool motor_emul_pwm_released(const struct device *dev)
+{
+	const struct motor_emul_pwm_data *data = dev->data;
+
+	return data->pulse[0] == 0 && data->pulse[1] == 0;
+}
+
+#define MOTOR_EMUL_PWM_DEFINE(inst)						\
+	static struct motor_emul_pwm_data motor_emul_pwm_data_##inst;		\
+	DEVICE_DT_INST_DEFINE(inst, NULL, NULL,					\
+			      &motor_emul_pwm_data_##inst, NULL,		\
+			      POST_KERNEL, CONFIG_PWM_INIT_PRIORITY,		\
+			      &motor_emul_pwm_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MOTOR_EMUL_PWM_DEFINE)
+
+// --- QDEC ---
+#undef DT_DRV_COMPAT
+#define DT_DRV_COMPAT app_motor_emul_qdec
+
+struct motor_emul_qdec_config{
+	const struct device *drive;	// app,motor-emul-pwm THAT POWERS THIS MOTOR
+	int32_t max_rpm;		// SPEED AT FULL DUTY
+	int32_t time_constant_ms;	// FIRST-ORDER SPEED RESPONSE
+	int32_t coast_time_constant_ms;	// SPEED DECAY WITH THE DRIVE RELEASED
+	bool no_rpm;			// ROTATION ONLY
+	bool relative;			// ROTATION = DELTA SINCE THE PREVIOUS FETCH
+};
+
+struct motor_emul_qdec_data{
+	int64_t last_ms;
+	int64_t rpm_milli;	// MODEL SPEED (RPM * 1000)
+	int64_t pos_udeg;	// MODEL ANGLE (MICRO-DEGREES, [0, 360e6))
+	int64_t delta_udeg;	// ROTATION OVER THE LAST FETCH (UNWRAPPED)
+};
+
+static int motor_emul_qdec_sample_fetch(const struct device *dev, enum sensor_channel chan)
+{
+	const struct motor_emul_qdec_config *cfg = dev->config;
+	struct motor_emul_qdec_data *data = dev->data;
+
+	int64_t now = k_uptime_get();
+	int64_t dt = now - data->last_ms;
+	data->last_ms = now;
+	if(dt > MOTOR_EMUL_MAX_STEP_MS) dt = MOTOR_EMUL_MAX_STEP_MS;
+
+	int64_t target = (int64_t)motor_emul_pwm_drive(cfg->drive) * cfg->max_rpm;	// PERMILLE * RPM = RPM * 1000
+	int32_t tau = motor_emul_pwm_released(cfg->drive) ? cfg->coast_time_constant_ms
+							    : cfg->time_constant_ms;
+
+	// 1 MS EULER STEPS -> STABLE FOR ANY TIME CONSTANT >= 1 MS
+	// EVERY FETCH STARTS A NEW DELTA -> WHAT THE PREVIOUS ONE REPORTED IS CLEARED, AS qdec_nrfx DOES
+	data->delta_udeg = 0;
+	for(int64_t i = 0; i < dt; i++){
+		// SETTLE ONCE THE STEP ROUNDS TO 0 -> NO ENDLESS CREEP BELOW tau MILLI-RPM
+		int64_t step = (target - data->rpm_milli) / tau;
+		data->rpm_milli = step ? data->rpm_milli + step : target;
+		// RPM * 360 DEG / 60000 MS = RPM * 6 MILLI-DEG PER MS = RPM_MILLI * 6 MICRO-DEG PER MS
+		data->delta_udeg += data->rpm_milli * 6;
+	}
+
+	data->pos_udeg = (data->pos_udeg + data->delta_udeg) % 360000000LL;
+	if(data->pos_udeg < 0) data->pos_udeg += 360000000LL;
+	return 0;
+}
+
+static int motor_emul_qdec_channel_get(const struct device *dev, enum sensor_channel chan,
+				       struct sensor_value *val)
+{
+	const struct motor_emul_qdec_config *cfg = dev->config;
+	const struct motor_emul_qdec_data *data = dev->data;
+
+	switch(chan){
+	case SENSOR_CHAN_ROTATION:
+		return sensor_value_from_micro(val, cfg->relative ? data->delta_udeg : data->pos_udeg);
+	case SENSOR_CHAN_RPM:
+		if(cfg->no_rpm){
+			return -ENOTSUP;
+		}
+		return sensor_value_from_milli(val, data->rpm_milli);
+	default:
+		return -ENOTSUP;
+	}
+}
+
+static DEVICE_API(sensor, motor_emul_qdec_api) = {
+	.sample_fetch = motor_emul_qdec_sample_fetch,
+	.channel_get = motor_emul_qdec_channel_get,
+};
+
+static int motor_emul_qdec_init(const struct device *dev)
+{
+	const struct motor_emul_qdec_config *cfg = dev->config;
+	struct motor_emul_qdec_data *data = dev->data;
+
+	if(!device_is_ready(cfg->drive)){
+		return -ENODEV;
+	}
+	data->last_ms = k_uptime_get();
+	return 0;
+}
+
+#define MOTOR_EMUL_QDEC_DEFINE(inst)						\
+	static struct motor_emul_qdec_data motor_emul_qdec_data_##inst;		\
+	static const struct motor_emul_qdec_config motor_emul_qdec_config_##inst = {	\
+		.drive = DEVICE_DT_GET(DT_INST_PHANDLE(inst, drive)),		\
+		.max_rpm = DT_INST_PROP(inst, max_rpm),				\
+		.time_constant_ms = MAX(DT_INST_PROP(inst, time_constant_ms), 1),	\
+		.coast_time_constant_ms = MAX(DT_INST_PROP_OR(inst, coast_time_constant_ms,	\
+					      DT_INST_PROP(inst, time_constant_ms)), 1),	\
+		.no_rpm = DT_INST_PROP(inst, no_rpm),				\
+		.relative = DT_INST_PROP(inst, relative_rotation),		\
+	};									\
+	SENSOR_DEVICE_DT_INST_DEFINE(inst, motor_emul_qdec_init, NULL,		\
+				     &motor_emul_qdec_data_##inst,		\
+				     &motor_emul_qdec_config_##inst,		\
+				     POST_KERNEL, CONFIG_SENSOR_INIT_PRIORITY,	\
+				     &motor_emul_qdec_api);
+
+DT_INST_FOREACH_STATUS_OKAY(MOTOR_EMUL_QDEC_DEFINE)
@@ -10,9 +10,11 @@
 #include <stdio.h>
 
 #include "bluetooth.h"
-#include "motor_sim.h"
+#include "motor_backend.h"
+#include "motor_loop.h"
 #include "watchdog.h"
 #include "motor.h" // Needed for motor_init
+#include "telemetry_log.h"
 
 LOG_MODULE_REGISTER(main, LOG_LEVEL_INF);
 
@@ -20,11 +22,18 @@ int main(void)
 {
     LOG_INF("Starting Bluetooth Motor Control Application");    
 
-    // 1. Initialize the Motor Data Structures (Safe API)
+    // 1. Initialize the Motor Data Structures (Safe API) and the selected backend
     motor_init(); 
+    telemetry_log_init();
+
+    int err = motor_backend_init();
+    if (err) {
+        LOG_ERR("Motor backend init failed (err %d)", err);
+        return 0;
+    }
 
     // 2. Initialize Bluetooth
-    int err = bt_enable(bt_ready);
+    err = bt_enable(bt_ready);
     if (err) {
         LOG_ERR("Bluetooth init failed (err %d)", err);
         return 0;
@@ -34,8 +43,8 @@ int main(void)
     bt_conn_cb_register(&conn_callbacks);
     watchdog_init();
 
-    // 4. Start the Physics Simulation
-    motor_sim_init();
+    // 4. Start the Control Loop (simulation or hardware, see CONFIG_APP_MOTOR_BACKEND)
+    motor_loop_init();
 
     return 0;
 }
\ No newline at end of file
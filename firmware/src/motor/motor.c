@@ -1,10 +1,16 @@
 #include "motor.h"
 
+#include <zephyr/sys/atomic.h>
 #include <string.h>
 #include <stdbool.h>
 
 static struct motor_stats m_stats;
 
+// KEPT OUT OF motor_status -> WRITTEN FROM THE BT THREAD WHILE THE MOTOR THREAD REWRITES THE STATE NIBBLE
+static atomic_t cmd_acks;
+// MOTOR_FLAG_CMD_ACK AS REPORTED -> LATCHED BY THE MOTOR THREAD BEFORE THE BACKEND READS THE TARGETS
+static uint8_t ack_flag;
+
 void motor_init(void){
     memset(&m_stats, 0, sizeof(m_stats)); // WIPE ALL THE DATA TO ZERO (EVEN PRE-EXISTING DATA)
 
@@ -42,6 +48,14 @@ void motor_set_overheat_warning(bool active){
     motor_set_flag(MOTOR_FLAG_OVERHEAT, active);
 }
 
+void motor_ack_command(void){
+    atomic_inc(&cmd_acks);
+}
+
+void motor_latch_command_ack(void){
+    ack_flag = (atomic_get(&cmd_acks) & 1) ? MOTOR_FLAG_CMD_ACK : 0;
+}
+
 void motor_set_target_state(uint8_t new_state){
     m_stats.target_state = new_state & MOTOR_STATE_MASK;
 }
@@ -54,14 +68,17 @@ void motor_set_target_speed(int32_t rpm){
 }
 
 void motor_set_target_position(int32_t degrees){
-    m_stats.current_position = degrees % 360;
+    int32_t a = degrees % 360;
+    if(a < 0) a += 360;     // NORMALIZE TO [0, 360)
+
+    m_stats.target_position = a;
 }
 
 
 // GETTERS
 
 uint8_t motor_get_full_status(void){
-    return m_stats.motor_status;
+    return (m_stats.motor_status & ~MOTOR_FLAG_CMD_ACK) | ack_flag;
 }
 
 bool motor_is_sync_bad(void){
@@ -0,0 +1,71 @@
+#include "motor_loop.h"
+#include "motor_backend.h"
+#include "motor.h"
+#include "bluetooth.h"        // For motor_notify_telemetry
+#include "telemetry_log.h"    // Per-tick history for backfill
+#include "telemetry_stream.h" // Per-tick L2CAP stream
+#include "teleop.h"           // Streamed setpoint interpolation
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(motor_loop, LOG_LEVEL_INF);
+
+/* Thread config */
+#define MOTOR_LOOP_STACK_SIZE 2048
+#define MOTOR_LOOP_PRIORITY   5
+
+K_THREAD_STACK_DEFINE(motor_loop_stack, MOTOR_LOOP_STACK_SIZE);
+static struct k_thread motor_loop_thread;
+static k_tid_t motor_loop_thread_id;
+
+static void motor_loop_tick(void)
+{
+    // 0. ADVANCE ANY STREAMED SETPOINT TO THIS TICK (MAY ALSO STOP ON A STALLED STREAM)
+    teleop_tick();
+
+    // Snapshots for change detection
+    int32_t prev_pos    = motor_get_position();
+    int32_t prev_speed  = motor_get_speed();
+    uint8_t prev_status = motor_get_full_status();
+
+    // ACK BIT FOR THIS TICK'S SAMPLES -> TAKEN BEFORE THE BACKEND READS THE TARGETS IT ACKNOWLEDGES
+    motor_latch_command_ack();
+
+    // 1. LET THE BACKEND MOVE THE MOTOR AND REPORT BACK THROUGH THE MOTOR API
+    motor_backend_update();
+
+    // 2. RECORD EVERY TICK SO SAMPLES MISSED DURING A DROPOUT CAN BE BACKFILLED
+    telemetry_log_record();
+    telemetry_stream_push_latest();
+
+    // 3. NOTIFY IF CHANGED -> GATT IS ONLY THE FALLBACK, THE OPEN L2CAP STREAM ALREADY CARRIES EVERY TICK
+    if (!telemetry_stream_is_connected() &&
+        (motor_get_position() != prev_pos ||
+         motor_get_speed()    != prev_speed ||
+         motor_get_full_status() != prev_status)) {
+
+        motor_notify_telemetry();
+    }
+}
+
+static void motor_loop_thread_fn(void *a, void *b, void *c)
+{
+    while (1) {
+        motor_loop_tick();
+        k_msleep(CONFIG_APP_MOTOR_TICK_MS);
+    }
+}
+
+void motor_loop_init(void)
+{
+    LOG_INF("Starting motor control thread (%d ms tick)", CONFIG_APP_MOTOR_TICK_MS);
+    motor_loop_thread_id = k_thread_create(
+        &motor_loop_thread, motor_loop_stack, MOTOR_LOOP_STACK_SIZE,
+        motor_loop_thread_fn, NULL, NULL, NULL,
+        MOTOR_LOOP_PRIORITY, 0, K_NO_WAIT);
+
+#if defined(CONFIG_THREAD_NAME)
+    k_thread_name_set(motor_loop_thread_id, "motor_loop");
+#endif
+}
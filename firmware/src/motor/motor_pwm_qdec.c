@@ -0,0 +1,290 @@
+#include "motor_backend.h"
+#include "motor.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/device.h>
+#include <zephyr/devicetree.h>
+#include <zephyr/drivers/pwm.h>
+#include <zephyr/drivers/sensor.h>
+#include <zephyr/logging/log.h>
+#include <stdlib.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(motor_pwm_qdec, LOG_LEVEL_INF);
+
+// PWM + QUADRATURE ENCODER BACKEND
+// DRIVE: TWO PWM CHANNELS INTO AN H-BRIDGE ("fwd"/"rev" -> IN1/IN2), BOTH AT 0 = COAST, BOTH FULL = BRAKE
+// FEEDBACK: A QDEC SENSOR REPORTING THE SHAFT ANGLE (SENSOR_CHAN_ROTATION) AND, IF THE DRIVER HAS IT,
+//           HARDWARE-MEASURED SPEED (SENSOR_CHAN_RPM). THE ANGLE IS EITHER ABSOLUTE [0, 360) (STM32) OR, WITH
+//           relative-rotation, THE ROTATION SINCE THE PREVIOUS FETCH (nRF qdec_nrfx CLEARS IT ON READ) -> THEN
+//           THE BACKEND INTEGRATES THE ANGLE ITSELF
+#define MOTOR_NODE DT_COMPAT_GET_ANY_STATUS_OKAY(app_motor_pwm_qdec)
+
+static const struct pwm_dt_spec drive_fwd = PWM_DT_SPEC_GET_BY_NAME(MOTOR_NODE, fwd);
+static const struct pwm_dt_spec drive_rev = PWM_DT_SPEC_GET_BY_NAME(MOTOR_NODE, rev);
+static const struct device *const encoder = DEVICE_DT_GET(DT_PHANDLE(MOTOR_NODE, encoder));
+
+// ENCODER REPORTS ROTATION SINCE THE LAST FETCH INSTEAD OF THE ABSOLUTE ANGLE
+#define ENCODER_RELATIVE    DT_PROP(MOTOR_NODE, relative_rotation)
+
+// NO-LOAD SPEED AT FULL DUTY -> FEED-FORWARD SCALE
+#define MOTOR_FREE_RPM      DT_PROP(MOTOR_NODE, max_rpm)
+
+// DUTY IS IN PERMILLE, THE SIGN PICKS THE DIRECTION
+#define DUTY_FULL           1000
+
+// SPEED LOOP: FEED-FORWARD + PI
+// P: PERMILLE PER 1000 RPM OF ERROR, I: PERMILLE PER 1000 RPM OF ERROR PER SECOND
+#define SPEED_KP            100
+#define SPEED_KI            500
+#define SPEED_I_SCALE       1000000LL   // INTEGRATOR IS KEPT IN PERMILLE * 1e6 (RPM * MS * KI)
+#define SPEED_I_BAND_RPM    200         // ONLY INTEGRATE NEAR THE TARGET -> FEED-FORWARD DOES THE STEP
+
+// POSITION LOOP: P ON THE SHORTEST ANGLE ERROR -> SPEED TARGET FOR THE SPEED LOOP
+#define POS_KP_RPM_PER_DEG  2
+#define POS_MAX_RPM         600
+#define POS_DEADBAND_DEG    1
+
+// SPEED FROM THE ABSOLUTE ANGLE DELTA ALIASES PAST HALF A TURN PER TICK -> WITHOUT SENSOR_CHAN_RPM TARGETS ARE
+// LIMITED TO A QUARTER TURN PER TICK (1000 RPM AT 15 MS), WHICH STILL HOLDS IF A TICK RUNS LATE.
+// A RELATIVE ENCODER COUNTS WHOLE TURNS, SO ITS DELTA NEVER ALIASES AND NEEDS NO LIMIT
+#define FALLBACK_MAX_RPM    (15000 / CONFIG_APP_MOTOR_TICK_MS)
+
+struct pwm_qdec_ctx{
+	bool primed;            // FIRST SAMPLE ONLY SEEDS THE TIMESTAMP/ANGLE
+	bool has_rpm;           // ENCODER DRIVER REPORTS SPEED ITSELF
+	bool fault_logged;
+	int32_t speed_limit;    // LARGEST |TARGET| THE SPEED MEASUREMENT CAN FOLLOW
+	int32_t limited_rpm;    // LAST OUT-OF-RANGE SPEED TARGET THAT WAS LOGGED
+	int32_t duty;           // LAST DRIVE (0 WHILE COASTING OR BRAKED)
+	int64_t last_us;        // WHEN THE PREVIOUS SAMPLE WAS LATCHED
+	int32_t last_mdeg;      // PREVIOUS ANGLE (MILLI-DEGREES, [0, 360000)) -> INTEGRATED HERE FOR A RELATIVE ENCODER
+	int64_t integ;          // SPEED LOOP INTEGRATOR
+};
+
+static struct pwm_qdec_ctx ctx;
+
+/* map an angle difference into [-180, 180] (shortest rotation) */
+static inline int32_t wrap_delta(int32_t d)
+{
+	d %= 360;
+	if (d > 180)  d -= 360;
+	if (d < -180) d += 360;
+	return d;
+}
+
+static inline int32_t clamp_i32(int32_t v, int32_t lo, int32_t hi)
+{
+	if (v > hi) return hi;
+	if (v < lo) return lo;
+	return v;
+}
+
+static int drive_set(int32_t duty){
+	duty = clamp_i32(duty, -DUTY_FULL, DUTY_FULL);
+
+	uint32_t fwd = duty > 0 ? (uint32_t)(((uint64_t)drive_fwd.period * duty) / DUTY_FULL) : 0;
+	uint32_t rev = duty < 0 ? (uint32_t)(((uint64_t)drive_rev.period * -duty) / DUTY_FULL) : 0;
+
+	// ALWAYS RELEASE ONE SIDE BEFORE DRIVING THE OTHER -> NEVER BOTH HIGH (BRAKE) MID-UPDATE
+	int err = pwm_set_pulse_dt(duty > 0 ? &drive_rev : &drive_fwd, duty > 0 ? rev : fwd);
+	if (!err) {
+		err = pwm_set_pulse_dt(duty > 0 ? &drive_fwd : &drive_rev, duty > 0 ? fwd : rev);
+	}
+	ctx.duty = duty;
+	return err;
+}
+
+// SHORT THE WINDING -> THE MOTOR RESISTS BEING TURNED INSTEAD OF COASTING ON ITS INERTIA
+static int drive_brake(void){
+	// RAISE THE IDLE SIDE FIRST -> THE STEP IN BETWEEN OPPOSES THE LAST DRIVE INSTEAD OF ADDING TO IT
+	const struct pwm_dt_spec *first = ctx.duty > 0 ? &drive_rev : &drive_fwd;
+	const struct pwm_dt_spec *second = ctx.duty > 0 ? &drive_fwd : &drive_rev;
+
+	int err = pwm_set_pulse_dt(first, first->period);
+	if (!err) {
+		err = pwm_set_pulse_dt(second, second->period);
+	}
+	ctx.duty = 0;
+	return err;
+}
+
+// LATCH ONE ENCODER SAMPLE -> ANGLE IN MILLI-DEGREES, SPEED IN RPM, TIMESTAMP RIGHT AT THE FETCH
+static int encoder_read(int32_t *mdeg, int32_t *rpm, int64_t *at_us){
+	int err = sensor_sample_fetch(encoder);
+	if (err) {
+		return err;
+	}
+	*at_us = k_ticks_to_us_near64(k_uptime_ticks());
+
+	struct sensor_value v;
+	err = sensor_channel_get(encoder, SENSOR_CHAN_ROTATION, &v);
+	if (err) {
+		return err;
+	}
+
+	int32_t d_mdeg;
+	if (ENCODER_RELATIVE) {
+		// ROTATION SINCE THE PREVIOUS FETCH -> ADD IT TO OUR OWN ANGLE (0 = WHERE THE SHAFT WAS AT BOOT)
+		d_mdeg = (int32_t)sensor_value_to_milli(&v);
+		*mdeg = (ctx.last_mdeg + d_mdeg % 360000) % 360000;
+		if (*mdeg < 0) *mdeg += 360000;
+	} else {
+		// ABSOLUTE ANGLE -> THE DELTA IS ONLY UNAMBIGUOUS BELOW HALF A TURN PER TICK
+		*mdeg = (int32_t)sensor_value_to_milli(&v);
+		d_mdeg = *mdeg - ctx.last_mdeg;
+		if (d_mdeg > 180000)  d_mdeg -= 360000;
+		if (d_mdeg < -180000) d_mdeg += 360000;
+	}
+
+	if (ctx.has_rpm && sensor_channel_get(encoder, SENSOR_CHAN_RPM, &v) == 0) {
+		*rpm = v.val1;
+		return 0;
+	}
+
+	// NO HARDWARE SPEED -> ANGLE DELTA OVER THE LATCHED INTERVAL (ABSOLUTE ENCODERS KEEP TARGETS UNDER
+	// FALLBACK_MAX_RPM, SEE limit_speed)
+	int64_t dt_us = *at_us - ctx.last_us;
+
+	// RPM = (d_mdeg / 360000) REV / (dt_us / 60e6) MIN
+	*rpm = (ctx.primed && dt_us > 0) ? (int32_t)((int64_t)d_mdeg * 500 / (3 * dt_us)) : 0;
+	return 0;
+}
+
+// CLAMP A SPEED TARGET TO WHAT THE ENCODER CAN MEASURE -> LOG EACH NEW OUT-OF-RANGE TARGET ONCE
+static int32_t limit_speed(int32_t target_rpm){
+	int32_t limited = clamp_i32(target_rpm, -ctx.speed_limit, ctx.speed_limit);
+	if (limited != target_rpm && target_rpm != ctx.limited_rpm) {
+		LOG_WRN("Speed %d rpm not measurable without encoder speed - limited to %d",
+			target_rpm, limited);
+		ctx.limited_rpm = target_rpm;
+	}
+	return limited;
+}
+
+// SPEED LOOP -> DUTY FOR target_rpm GIVEN THE MEASURED rpm OVER dt_ms
+static int32_t speed_loop(int32_t target_rpm, int32_t rpm, int32_t dt_ms){
+	int32_t error = target_rpm - rpm;
+
+	// ANTI-WINDUP -> NO INTEGRATION DURING LARGE STEPS, AND NEVER MORE THAN FULL DUTY FROM IT ALONE
+	if (abs(error) <= SPEED_I_BAND_RPM) {
+		ctx.integ += (int64_t)error * dt_ms * SPEED_KI;
+	}
+	int64_t limit = (int64_t)DUTY_FULL * SPEED_I_SCALE;
+	if (ctx.integ > limit)  ctx.integ = limit;
+	if (ctx.integ < -limit) ctx.integ = -limit;
+
+	int32_t ff = (int32_t)(((int64_t)target_rpm * DUTY_FULL) / MOTOR_FREE_RPM);
+	int32_t p  = (error * SPEED_KP) / 1000;
+	int32_t i  = (int32_t)(ctx.integ / SPEED_I_SCALE);
+
+	return clamp_i32(ff + p + i, -DUTY_FULL, DUTY_FULL);
+}
+
+void motor_backend_update(void)
+{
+	int32_t mdeg, rpm;
+	int64_t now_us;
+
+	if (encoder_read(&mdeg, &rpm, &now_us) != 0) {
+		// NO FEEDBACK -> DO NOT DRIVE BLIND
+		drive_set(0);
+		ctx.integ = 0;
+		motor_set_state(MOTOR_STATE_FAULT);
+		if (!ctx.fault_logged) {
+			LOG_ERR("Encoder read failed - drive released");
+			ctx.fault_logged = true;
+		}
+		return;
+	}
+	ctx.fault_logged = false;
+
+	int32_t dt_ms = ctx.primed ? (int32_t)((now_us - ctx.last_us) / 1000) : 0;
+	ctx.primed = true;
+	ctx.last_us = now_us;
+	ctx.last_mdeg = mdeg;
+
+	int32_t pos = (mdeg + 500) / 1000;  // ROUND TO WHOLE DEGREES
+	if (pos >= 360) pos -= 360;
+
+	int32_t duty = 0;
+	bool brake = false;
+
+	switch (motor_get_target_state()) {
+	case MOTOR_STATE_RUNNING_SPEED:
+		motor_set_state(MOTOR_STATE_RUNNING_SPEED);
+		duty = speed_loop(limit_speed(motor_get_target_speed()), rpm, dt_ms);
+		break;
+
+	case MOTOR_STATE_RUNNING_POS: {
+		int32_t error = wrap_delta(motor_get_target_position() - pos);
+
+		if (abs(error) <= POS_DEADBAND_DEG) {
+			// AT TARGET -> HOLD IT BRAKED (SAME AS THE SIM REPORTING STOPPED). A RELEASED DRIVE WOULD
+			// COAST THROUGH THE BAND ON THE ROTOR'S INERTIA, OR BE BACK-DRIVEN BY A LOAD, AND HUNT
+			ctx.integ = 0;
+			brake = true;
+			motor_set_state(MOTOR_STATE_STOPPED);
+		} else {
+			motor_set_state(MOTOR_STATE_RUNNING_POS);
+			int32_t max_rpm = MIN(POS_MAX_RPM, ctx.speed_limit);
+			int32_t target_rpm = clamp_i32(error * POS_KP_RPM_PER_DEG, -max_rpm, max_rpm);
+			duty = speed_loop(target_rpm, rpm, dt_ms);
+		}
+		break;
+	}
+
+	case MOTOR_STATE_STOPPED:
+	case MOTOR_STATE_ESTOP:
+	default:
+		// COAST -> SPEED DECAYS ON ITS OWN AND IS STILL REPORTED FROM THE ENCODER
+		ctx.integ = 0;
+		motor_set_state(MOTOR_STATE_STOPPED);
+		break;
+	}
+
+	if ((brake ? drive_brake() : drive_set(duty)) != 0) {
+		motor_set_state(MOTOR_STATE_FAULT);
+	}
+
+	motor_set_speed(rpm);
+	motor_set_position(pos);
+}
+
+int motor_backend_init(void)
+{
+	if (!pwm_is_ready_dt(&drive_fwd) || !pwm_is_ready_dt(&drive_rev)) {
+		LOG_ERR("Drive PWM not ready");
+		return -ENODEV;
+	}
+	if (!device_is_ready(encoder)) {
+		LOG_ERR("Encoder %s not ready", encoder->name);
+		return -ENODEV;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+
+	int err = drive_set(0);
+	if (err) {
+		LOG_ERR("Drive PWM set failed (err %d)", err);
+		return err;
+	}
+
+	// PROBE FOR HARDWARE SPEED ONCE INSTEAD OF ON EVERY TICK (A RELATIVE ENCODER DROPS THE ROTATION SINCE BOOT
+	// HERE -> THE ANGLE STARTS AT 0 FROM THIS FETCH)
+	struct sensor_value v;
+	ctx.has_rpm = sensor_sample_fetch(encoder) == 0 &&
+		      sensor_channel_get(encoder, SENSOR_CHAN_RPM, &v) == 0;
+	ctx.speed_limit = (ctx.has_rpm || ENCODER_RELATIVE) ? INT32_MAX : FALLBACK_MAX_RPM;
+
+	if (ctx.has_rpm) {
+		LOG_INF("Motor backend: PWM + QDEC (%s%s, speed from encoder)", encoder->name,
+			ENCODER_RELATIVE ? ", relative" : "");
+	} else if (ENCODER_RELATIVE) {
+		LOG_INF("Motor backend: PWM + QDEC (%s, relative, speed from rotation delta)", encoder->name);
+	} else {
+		LOG_INF("Motor backend: PWM + QDEC (%s, speed from angle delta, max %d rpm)",
+			encoder->name, FALLBACK_MAX_RPM);
+	}
+	return 0;
+}
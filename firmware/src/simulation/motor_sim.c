@@ -1,5 +1,4 @@
-#include "motor_sim.h"
-#include "bluetooth.h" // For motor_notify_telemetry
+#include "motor_backend.h"
 #include "motor.h"     // For the Public API
 #include <zephyr/kernel.h>
 #include <zephyr/logging/log.h>
@@ -8,18 +7,10 @@
 
 LOG_MODULE_REGISTER(motor_sim, LOG_LEVEL_INF);
 
-/* Thread config */
-#define MOTOR_SIM_STACK_SIZE 2048
-#define MOTOR_SIM_PRIORITY   5
-
 /* Safety limits */
 #define MOTOR_MAX_SPEED     6000 
 #define MOTOR_MIN_SPEED    -6000
 
-K_THREAD_STACK_DEFINE(motor_sim_stack, MOTOR_SIM_STACK_SIZE);
-static struct k_thread motor_sim_thread;
-static k_tid_t motor_sim_thread_id;
-
 static inline int32_t small_step_signed(int32_t value, float factor)
 {
     int32_t step = (int32_t)(value * factor);
@@ -47,17 +38,13 @@ static inline int32_t clamp_speed(int32_t s)
     return s;
 }
 
-void motor_sim_update(void)
+// SIM BACKEND -> SIMULATED PHYSICS, ONE STEP PER CONTROL TICK (NO HARDWARE)
+void motor_backend_update(void)
 {
     // 1. READ CURRENT STATE (Local copies for calculation)
     int32_t curr_pos    = motor_get_position();
     int32_t curr_speed  = motor_get_speed();
     uint8_t target_mode = motor_get_target_state();
-    
-    // Snapshots for change detection
-    int32_t prev_pos    = curr_pos;
-    int32_t prev_speed  = curr_speed;
-    uint8_t prev_status = motor_get_full_status();
 
     // 2. RUN SIMULATION LOGIC
     switch (target_mode) {
@@ -135,35 +122,10 @@ void motor_sim_update(void)
     // 3. WRITE BACK TO MOTOR API
     motor_set_speed(curr_speed);
     motor_set_position(curr_pos);
-
-    // 4. NOTIFY IF CHANGED
-    // We check the API's current values against our snapshots
-    if (motor_get_position() != prev_pos ||
-        motor_get_speed()    != prev_speed ||
-        motor_get_full_status() != prev_status) {
-        
-        motor_notify_telemetry();
-    }
-}
-
-static void motor_sim_thread_fn(void *a, void *b, void *c)
-{
-    const int period_ms = 15; 
-    while (1) {
-        motor_sim_update();
-        k_msleep(period_ms);
-    }
 }
 
-void motor_sim_init(void)
+int motor_backend_init(void)
 {
-    LOG_INF("Starting motor simulation thread");
-    motor_sim_thread_id = k_thread_create(
-        &motor_sim_thread, motor_sim_stack, MOTOR_SIM_STACK_SIZE,
-        motor_sim_thread_fn, NULL, NULL, NULL,
-        MOTOR_SIM_PRIORITY, 0, K_NO_WAIT);
-
-#if defined(CONFIG_THREAD_NAME)
-    k_thread_name_set(motor_sim_thread_id, "motor_sim");
-#endif
+    LOG_INF("Motor backend: simulation");
+    return 0;
 }
\ No newline at end of file
@@ -0,0 +1,167 @@
+#include "telemetry_stream.h"
+#include "telemetry_log.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+#include <zephyr/bluetooth/bluetooth.h>
+#include <zephyr/bluetooth/conn.h>
+#include <zephyr/bluetooth/l2cap.h>
+#include <zephyr/net_buf.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+LOG_MODULE_REGISTER(telemetry_stream, LOG_LEVEL_INF);
+
+#define STREAM_BATCH	CONFIG_APP_TELEMETRY_STREAM_BATCH
+#define STREAM_SDU_LEN	(TELEMETRY_STREAM_HDR_LEN + STREAM_BATCH * TELEMETRY_SAMPLE_LEN)
+#define STREAM_TX_BUFS	4	// SDUS IN FLIGHT WHILE WAITING FOR CREDITS
+#define STREAM_RX_MTU	23	// APP NEVER SENDS ON THIS CHANNEL
+
+// TX POOL -> WHEN IT RUNS DRY THE PEER IS OUT OF CREDITS, SO THE BATCH IS DROPPED INSTEAD OF
+// BLOCKING THE CONTROL LOOP (MISSED SAMPLES CAN STILL BE BACKFILLED FROM THE HISTORY RING)
+NET_BUF_POOL_FIXED_DEFINE(stream_tx_pool, STREAM_TX_BUFS,
+			  BT_L2CAP_SDU_BUF_SIZE(STREAM_SDU_LEN), 8, NULL);
+
+static struct bt_l2cap_le_chan stream_chan;
+static atomic_t stream_connected;
+
+// BATCH BEING FILLED BY THE CONTROL LOOP
+static uint8_t batch[STREAM_SDU_LEN];
+static uint16_t batch_count;
+static uint16_t batch_limit;	// SAMPLES PER SDU -> STREAM_BATCH, LOWERED TO FIT THE PEER'S MTU
+static int64_t batch_started_ms;
+static uint32_t dropped_samples;
+
+// PRODUCER IS THE MOTOR THREAD, THE CHANNEL CALLBACKS RESET IT FROM THE BT THREAD
+static struct k_spinlock batch_lock;
+
+static void stream_connected_cb(struct bt_l2cap_chan *chan){
+	// SIZE THE BATCH TO THE NEGOTIATED MTU ONCE -> EVERY FLUSH FITS ONE SDU, NOTHING IS TRUNCATED
+	uint16_t fit = (stream_chan.tx.mtu - TELEMETRY_STREAM_HDR_LEN) / TELEMETRY_SAMPLE_LEN;
+
+	k_spinlock_key_t key = k_spin_lock(&batch_lock);
+	batch_count = 0;
+	batch_limit = CLAMP(fit, 1, STREAM_BATCH);
+	dropped_samples = 0;
+	k_spin_unlock(&batch_lock, key);
+
+	atomic_set(&stream_connected, 1);
+	LOG_INF("Telemetry stream open (tx mtu %u, mps %u, %u samples per SDU)",
+		stream_chan.tx.mtu, stream_chan.tx.mps, batch_limit);
+}
+
+static void stream_disconnected_cb(struct bt_l2cap_chan *chan){
+	atomic_set(&stream_connected, 0);
+	LOG_INF("Telemetry stream closed (%u samples dropped)", dropped_samples);
+}
+
+static int stream_recv_cb(struct bt_l2cap_chan *chan, struct net_buf *buf){
+	// NOTHING IS EXPECTED FROM THE APP -> ACCEPT AND DISCARD
+	return 0;
+}
+
+static const struct bt_l2cap_chan_ops stream_ops = {
+	.connected = stream_connected_cb,
+	.disconnected = stream_disconnected_cb,
+	.recv = stream_recv_cb,
+};
+
+static int stream_accept(struct bt_conn *conn, struct bt_l2cap_server *server,
+			 struct bt_l2cap_chan **chan)
+{
+	// ONE STREAM AT A TIME
+	if(atomic_get(&stream_connected)){
+		return -ENOMEM;
+	}
+
+	memset(&stream_chan, 0, sizeof(stream_chan));
+	stream_chan.chan.ops = &stream_ops;
+	stream_chan.rx.mtu = STREAM_RX_MTU;
+	*chan = &stream_chan.chan;
+
+	return 0;
+}
+
+static struct bt_l2cap_server stream_server = {
+	.psm = CONFIG_APP_TELEMETRY_STREAM_PSM,
+	.sec_level = BT_SECURITY_L1,
+	.accept = stream_accept,
+};
+
+// HAND THE FILLED BATCH OVER -> CALLED WITH batch_lock HELD, RETURNS THE SDU TO SEND (OR NULL)
+static struct net_buf *stream_take_batch(void){
+	uint16_t count = batch_count;
+	batch_count = 0;
+
+	struct net_buf *buf = net_buf_alloc(&stream_tx_pool, K_NO_WAIT);
+	if(!buf){
+		dropped_samples += count;
+		return NULL;
+	}
+	net_buf_reserve(buf, BT_L2CAP_SDU_CHAN_SEND_RESERVE);
+
+	sys_put_le16(count, batch);
+	net_buf_add_mem(buf, batch, TELEMETRY_STREAM_HDR_LEN + count * TELEMETRY_SAMPLE_LEN);
+	return buf;
+}
+
+static void stream_send(struct net_buf *buf){
+	uint16_t count = sys_get_le16(buf->data);
+
+	int err = bt_l2cap_chan_send(&stream_chan.chan, buf);
+	if(err < 0){
+		// BUFFER IS STILL OURS ON ERROR
+		net_buf_unref(buf);
+
+		k_spinlock_key_t key = k_spin_lock(&batch_lock);
+		dropped_samples += count;
+		k_spin_unlock(&batch_lock, key);
+		LOG_DBG("Stream send failed (err %d)", err);
+	}
+}
+
+void telemetry_stream_push_latest(void){
+	if(!atomic_get(&stream_connected)){
+		return;
+	}
+
+	struct telemetry_sample s;
+	if(!telemetry_log_latest(&s)){
+		return;
+	}
+
+	struct net_buf *buf = NULL;
+	int64_t now = k_uptime_get();
+
+	k_spinlock_key_t key = k_spin_lock(&batch_lock);
+	if(batch_count == 0){
+		batch_started_ms = now;
+	}
+	telemetry_sample_pack(&s, &batch[TELEMETRY_STREAM_HDR_LEN + batch_count * TELEMETRY_SAMPLE_LEN]);
+	batch_count++;
+
+	// SEND WHEN THE SDU IS FULL OR THE OLDEST SAMPLE HAS WAITED TOO LONG
+	if(batch_count >= batch_limit ||
+	   now - batch_started_ms >= CONFIG_APP_TELEMETRY_STREAM_FLUSH_MS){
+		buf = stream_take_batch();
+	}
+	k_spin_unlock(&batch_lock, key);
+
+	// bt_l2cap_chan_send() MAY TAKE KERNEL LOCKS -> NEVER UNDER THE SPINLOCK
+	if(buf){
+		stream_send(buf);
+	}
+}
+
+bool telemetry_stream_is_connected(void){
+	return atomic_get(&stream_connected);
+}
+
+void telemetry_stream_init(void){
+	int err = bt_l2cap_server_register(&stream_server);
+	if(err){
+		LOG_ERR("L2CAP stream server register failed (err %d)", err);
+		return;
+	}
+	LOG_INF("Telemetry stream listening on PSM 0x%02X", stream_server.psm);
+}
@@ -0,0 +1,82 @@
+#include "telemetry_log.h"
+#include "motor.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/sys/byteorder.h>
+#include <string.h>
+
+BUILD_ASSERT((TELEMETRY_LOG_DEPTH & (TELEMETRY_LOG_DEPTH - 1)) == 0,
+	     "TELEMETRY_LOG_DEPTH must be a power of two");
+
+#define TELEMETRY_LOG_MASK (TELEMETRY_LOG_DEPTH - 1)
+
+// RING OF THE LAST TELEMETRY_LOG_DEPTH SAMPLES - SLOT IS (seq & MASK)
+static struct telemetry_sample ring[TELEMETRY_LOG_DEPTH];
+static uint32_t next_seq;	// SEQ THE NEXT RECORDED SAMPLE WILL GET (== NUMBER RECORDED)
+
+// PRODUCER IS THE MOTOR THREAD, CONSUMERS ARE THE BLE CALLBACKS / WORKQUEUE
+static struct k_spinlock lock;
+
+void telemetry_log_init(void){
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	memset(ring, 0, sizeof(ring));
+	next_seq = 0;
+	k_spin_unlock(&lock, key);
+}
+
+uint32_t telemetry_log_record(void){
+	struct telemetry_sample s = {
+		.timestamp_ms = k_uptime_get_32(),
+		.status = motor_get_full_status(),
+		.speed = motor_get_speed(),
+		.position = motor_get_position(),
+	};
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	s.seq = next_seq++;
+	ring[s.seq & TELEMETRY_LOG_MASK] = s;
+	k_spin_unlock(&lock, key);
+
+	return s.seq;
+}
+
+bool telemetry_log_latest(struct telemetry_sample *out){
+	bool found = false;
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	if(next_seq > 0){
+		*out = ring[(next_seq - 1) & TELEMETRY_LOG_MASK];
+		found = true;
+	}
+	k_spin_unlock(&lock, key);
+
+	return found;
+}
+
+size_t telemetry_log_read(uint32_t from_seq, struct telemetry_sample *out, size_t max){
+	size_t n = 0;
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	// OLDEST SAMPLE STILL IN THE RING
+	uint32_t oldest = (next_seq > TELEMETRY_LOG_DEPTH) ? next_seq - TELEMETRY_LOG_DEPTH : 0;
+	if(from_seq < oldest){
+		from_seq = oldest;
+	}
+
+	for(uint32_t seq = from_seq; seq < next_seq && n < max; seq++){
+		out[n++] = ring[seq & TELEMETRY_LOG_MASK];
+	}
+
+	k_spin_unlock(&lock, key);
+
+	return n;
+}
+
+void telemetry_sample_pack(const struct telemetry_sample *s, uint8_t out[TELEMETRY_SAMPLE_LEN]){
+	out[0] = s->status;
+	sys_put_le32(s->speed, &out[1]);
+	sys_put_le32(s->position, &out[5]);
+	sys_put_le32(s->seq, &out[9]);
+	sys_put_le32(s->timestamp_ms, &out[13]);
+}
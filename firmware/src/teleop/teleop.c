@@ -0,0 +1,139 @@
+#include "teleop.h"
+#include "motor.h"
+#include "bluetooth.h" // For enum motor_cmds
+
+#include <zephyr/kernel.h>
+#include <zephyr/logging/log.h>
+
+LOG_MODULE_REGISTER(teleop, LOG_LEVEL_INF);
+
+// LIMITS FOR THE MEASURED UPDATE INTERVAL (MS) -> KEEPS ONE EARLY/LATE PACKET FROM BLOWING UP THE SLOPE
+#define TELEOP_MIN_INTERVAL_MS	5
+#define TELEOP_MAX_INTERVAL_MS	TELEOP_STALL_MS
+
+struct teleop_ctx{
+	bool active;
+	bool has_seq;			// last_seq IS VALID -> KEPT ACROSS teleop_stop(), CLEARED BY teleop_reset()
+	uint8_t mode;			// MOTOR_MODE_SPEED OR MOTOR_MODE_POSITION
+	uint16_t last_seq;
+
+	// LAST TWO ACCEPTED SETPOINTS -> INTERPOLATE FROM prev TOWARDS last OVER ONE UPDATE INTERVAL
+	int32_t prev_value;
+	int32_t last_value;
+	int64_t last_ms;		// WHEN last_value ARRIVED
+	int32_t interval_ms;	// MEASURED TIME BETWEEN THE LAST TWO SETPOINTS
+};
+
+static struct teleop_ctx teleop;
+
+// SETPOINTS ARRIVE ON THE BT RX THREAD, THE TICK RUNS ON THE MOTOR THREAD. THE TICK ALSO WRITES THE MOTOR
+// TARGETS UNDER IT -> write_motor()'s teleop_stop() CAN'T LAND BETWEEN THE ACTIVE CHECK AND THOSE WRITES
+// AND HAVE ITS STOP OVERWRITTEN BY A STALE JOG TARGET
+static struct k_spinlock lock;
+
+/* map an angle difference into [-180, 180] (shortest rotation) */
+static inline int32_t wrap_delta(int32_t d)
+{
+	d %= 360;
+	if (d > 180)  d -= 360;
+	if (d < -180) d += 360;
+	return d;
+}
+
+bool teleop_on_setpoint(uint8_t mode, uint16_t seq, int32_t value){
+	if(mode != MOTOR_MODE_SPEED && mode != MOTOR_MODE_POSITION){
+		return false;
+	}
+
+	int64_t now = k_uptime_get();
+	bool accepted = true;
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if(teleop.has_seq && (int16_t)(seq - teleop.last_seq) <= 0){
+		// OUT OF ORDER OR DUPLICATE (WRAP-AROUND SAFE COMPARISON). ALSO CHECKED WHILE STOPPED ->
+		// A SETPOINT STILL IN FLIGHT WHEN A SHUTDOWN LANDED MUST NOT RESTART THE MOTOR
+		accepted = false;
+	} else if(!teleop.active || teleop.mode != mode){
+		// NEW STREAM (OR MODE SWITCH) -> NO HISTORY TO INTERPOLATE FROM YET
+		teleop.active = true;
+		teleop.mode = mode;
+		teleop.prev_value = value;
+		teleop.interval_ms = TELEOP_MAX_INTERVAL_MS;
+	} else {
+		int32_t dt = (int32_t)(now - teleop.last_ms);
+		if(dt < TELEOP_MIN_INTERVAL_MS) dt = TELEOP_MIN_INTERVAL_MS;
+		if(dt > TELEOP_MAX_INTERVAL_MS) dt = TELEOP_MAX_INTERVAL_MS;
+
+		teleop.interval_ms = dt;
+		teleop.prev_value = teleop.last_value;
+	}
+
+	if(accepted){
+		teleop.has_seq = true;
+		teleop.last_seq = seq;
+		teleop.last_value = value;
+		teleop.last_ms = now;
+	}
+
+	k_spin_unlock(&lock, key);
+
+	if(!accepted){
+		LOG_DBG("Stale setpoint %u dropped", seq);
+	}
+	return accepted;
+}
+
+void teleop_tick(void){
+	int64_t now = k_uptime_get();
+
+	k_spinlock_key_t key = k_spin_lock(&lock);
+
+	if(!teleop.active){
+		k_spin_unlock(&lock, key);
+		return;
+	}
+
+	int32_t age = (int32_t)(now - teleop.last_ms);
+	if(age > TELEOP_STALL_MS){
+		// STREAM STALLED -> SAFE DECEL TO A STOP (SAME PATH AS A SHUTDOWN COMMAND)
+		teleop.active = false;
+		motor_set_target_state(MOTOR_STATE_STOPPED);
+		motor_set_target_speed(0);
+		k_spin_unlock(&lock, key);
+
+		LOG_WRN("Setpoint stream stalled (%d ms) - decelerating", age);
+		return;
+	}
+
+	// PROGRESS THROUGH THE CURRENT INTERVAL IN PERCENT -> 100 = AT THE NEWEST SETPOINT, ABOVE = EXTRAPOLATING
+	int32_t pct = (age * 100) / teleop.interval_ms;
+	if(pct > 100 + TELEOP_EXTRAPOLATE_PCT) pct = 100 + TELEOP_EXTRAPOLATE_PCT;
+
+	int32_t from = teleop.prev_value;
+	int32_t delta = teleop.last_value - teleop.prev_value;
+
+	// PLAIN STORES INTO THE MOTOR API -> CHEAP ENOUGH TO KEEP UNDER THE SPINLOCK
+	if(teleop.mode == MOTOR_MODE_SPEED){
+		motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+		motor_set_target_speed(from + (delta * pct) / 100);
+	} else {
+		motor_set_target_state(MOTOR_STATE_RUNNING_POS);
+		motor_set_target_position(from + (wrap_delta(delta) * pct) / 100);
+	}
+
+	k_spin_unlock(&lock, key);
+}
+
+void teleop_stop(void){
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	teleop.active = false;
+	k_spin_unlock(&lock, key);
+}
+
+void teleop_reset(void){
+	k_spinlock_key_t key = k_spin_lock(&lock);
+	teleop.active = false;
+	teleop.has_seq = false;
+	k_spin_unlock(&lock, key);
+}
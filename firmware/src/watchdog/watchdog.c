@@ -1,6 +1,5 @@
 #include "watchdog.h"
 #include <zephyr/logging/log.h>
-#include "motor_sim.h"
 #include "bluetooth.h"
 #include "motor.h"
 
@@ -0,0 +1,183 @@
+#include "motor.h"
+#include "motor_backend.h"
+
+#include <zephyr/kernel.h>
+#include <zephyr/ztest.h>
+#include <stdlib.h>
+
+// CLOSED LOOP AGAINST THE EMULATED MOTOR (app,motor-emul-qdec: 6000 RPM AT FULL DUTY, 80 MS TIME CONSTANT)
+// THE no_rpm SCENARIO (testcase.yaml) HIDES SENSOR_CHAN_RPM, SO THE SAME TESTS RUN ON THE ANGLE-DELTA FALLBACK,
+// THE inertia SCENARIO LETS A RELEASED MOTOR COAST FOR ~1 S, THE relative SCENARIO REPORTS ROTATION SINCE THE
+// LAST FETCH (nRF qdec_nrfx) SO THE BACKEND INTEGRATES THE ANGLE
+#define EMUL_NODE DT_NODELABEL(motor_emul_qdec)
+#define MOTOR_NODE DT_NODELABEL(motor0)
+
+BUILD_ASSERT(DT_PROP(EMUL_NODE, relative_rotation) == DT_PROP(MOTOR_NODE, relative_rotation),
+	     "relative-rotation must be set on both the encoder and the motor node");
+
+// SPEED FROM THE ABSOLUTE ANGLE DELTA IS LIMITED, A RELATIVE DELTA NEVER ALIASES
+#define ANGLE_DELTA_LIMITED (DT_PROP(EMUL_NODE, no_rpm) && !DT_PROP(EMUL_NODE, relative_rotation))
+
+// TICKS TO WAIT FOR A COAST DOWN -> SCALED BY HOW MUCH SLOWER THE MOTOR COASTS THAN IT IS DRIVEN
+#define COAST_TICKS(n) ((n) * DT_PROP_OR(EMUL_NODE, coast_time_constant_ms,		\
+					 DT_PROP(EMUL_NODE, time_constant_ms)) /		\
+			DT_PROP(EMUL_NODE, time_constant_ms))
+
+#if ANGLE_DELTA_LIMITED
+#define SPEED_LIMIT_RPM (15000 / CONFIG_APP_MOTOR_TICK_MS)  // FALLBACK_MAX_RPM IN motor_pwm_qdec.c
+#else
+#define SPEED_LIMIT_RPM DT_PROP(EMUL_NODE, max_rpm)
+#endif
+
+static void run_ticks(int n)
+{
+	for (int i = 0; i < n; i++) {
+		k_msleep(CONFIG_APP_MOTOR_TICK_MS);
+		motor_backend_update();
+	}
+}
+
+static int32_t angle_error(int32_t target)
+{
+	int32_t d = (target - motor_get_position()) % 360;
+	if (d > 180)  d -= 360;
+	if (d < -180) d += 360;
+	return d;
+}
+
+static void *motor_setup(void)
+{
+	motor_init();
+	zassert_ok(motor_backend_init(), "backend init failed");
+	return NULL;
+}
+
+static void motor_before(void *f)
+{
+	// START EVERY TEST FROM REST -> COAST DOWN WHATEVER THE PREVIOUS TEST LEFT SPINNING
+	motor_set_target_state(MOTOR_STATE_STOPPED);
+	motor_set_target_speed(0);
+	run_ticks(COAST_TICKS(100));
+	zassert_within(motor_get_speed(), 0, 1, "motor did not coast to rest");
+}
+
+ZTEST_SUITE(motor_pwm_qdec, NULL, motor_setup, motor_before, NULL, NULL);
+
+ZTEST(motor_pwm_qdec, test_speed_step_settles)
+{
+	motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+	int32_t target = MIN(1500, SPEED_LIMIT_RPM);
+
+	motor_set_target_speed(target);
+	run_ticks(100);
+
+	zassert_equal(motor_get_full_status() & MOTOR_STATE_MASK, MOTOR_STATE_RUNNING_SPEED);
+	zassert_within(motor_get_speed(), target, 30, "speed %d", motor_get_speed());
+}
+
+ZTEST(motor_pwm_qdec, test_reverse_speed)
+{
+	motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+	motor_set_target_speed(-800);
+	run_ticks(100);
+
+	zassert_within(motor_get_speed(), -800, 16, "speed %d", motor_get_speed());
+}
+
+ZTEST(motor_pwm_qdec, test_position_takes_shortest_path)
+{
+	int32_t start = motor_get_position();
+	int32_t target = (start + 270) % 360;   // 90 DEGREES BACKWARDS IS SHORTER
+
+	motor_set_target_state(MOTOR_STATE_RUNNING_POS);
+	motor_set_target_position(target);
+
+	bool went_backwards = false;
+	for (int i = 0; i < 200; i++) {
+		run_ticks(1);
+		went_backwards |= motor_get_speed() < 0;
+	}
+
+	zassert_true(went_backwards, "did not turn the short way");
+	zassert_true(abs(angle_error(target)) <= 2, "angle %d, target %d",
+		     motor_get_position(), target);
+	zassert_equal(motor_get_full_status() & MOTOR_STATE_MASK, MOTOR_STATE_STOPPED);
+}
+
+ZTEST(motor_pwm_qdec, test_position_holds_at_target)
+{
+	int32_t target = (motor_get_position() + 90) % 360;
+
+	motor_set_target_state(MOTOR_STATE_RUNNING_POS);
+	motor_set_target_position(target);
+	run_ticks(150);
+
+	// BRAKED AT TARGET -> STAYS IN THE DEADBAND. A RELEASED DRIVE COASTS OUT OF IT ON THE INERTIA AND HUNTS
+	for (int i = 0; i < 100; i++) {
+		run_ticks(1);
+		zassert_true(abs(angle_error(target)) <= 1, "tick %d: angle %d, target %d", i,
+			     motor_get_position(), target);
+		zassert_equal(motor_get_full_status() & MOTOR_STATE_MASK, MOTOR_STATE_STOPPED,
+			      "tick %d: left the hold", i);
+	}
+}
+
+ZTEST(motor_pwm_qdec, test_fallback_speed_is_limited)
+{
+	if (!ANGLE_DELTA_LIMITED) {
+		ztest_test_skip();
+	}
+
+	// PAST HALF A TURN PER TICK THE ANGLE DELTA WOULD ALIAS AND THE LOOP RUN AWAY -> HELD AT THE LIMIT INSTEAD
+	motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+	motor_set_target_speed(6000);
+	run_ticks(100);
+
+	zassert_equal(motor_get_full_status() & MOTOR_STATE_MASK, MOTOR_STATE_RUNNING_SPEED);
+	zassert_within(motor_get_speed(), SPEED_LIMIT_RPM, 20, "speed %d", motor_get_speed());
+
+	motor_set_target_speed(-6000);
+	run_ticks(100);
+
+	zassert_within(motor_get_speed(), -SPEED_LIMIT_RPM, 20, "speed %d", motor_get_speed());
+}
+
+ZTEST(motor_pwm_qdec, test_relative_speed_past_half_turn)
+{
+	if (!DT_PROP(EMUL_NODE, relative_rotation)) {
+		ztest_test_skip();
+	}
+
+	// 4000 RPM = 1 TURN PER 15 MS TICK -> AN ABSOLUTE ANGLE WOULD LOOK STILL, THE ROTATION SINCE THE LAST FETCH DOES NOT
+	motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+	motor_set_target_speed(4000);
+	run_ticks(100);
+
+	zassert_within(motor_get_speed(), 4000, 80, "speed %d", motor_get_speed());
+
+	// AND THE INTEGRATED ANGLE STILL LANDS A POSITION TARGET
+	int32_t target = (motor_get_position() + 120) % 360;
+
+	motor_set_target_state(MOTOR_STATE_RUNNING_POS);
+	motor_set_target_position(target);
+	run_ticks(COAST_TICKS(200));
+
+	zassert_true(abs(angle_error(target)) <= 1, "angle %d, target %d", motor_get_position(), target);
+}
+
+ZTEST(motor_pwm_qdec, test_stop_coasts_down)
+{
+	int32_t target = MIN(3000, SPEED_LIMIT_RPM);
+
+	motor_set_target_state(MOTOR_STATE_RUNNING_SPEED);
+	motor_set_target_speed(target);
+	run_ticks(60);
+	zassert_true(motor_get_speed() > target * 5 / 6, "speed %d", motor_get_speed());
+
+	motor_set_target_state(MOTOR_STATE_STOPPED);
+	motor_set_target_speed(0);
+	run_ticks(COAST_TICKS(60));
+
+	zassert_equal(motor_get_full_status() & MOTOR_STATE_MASK, MOTOR_STATE_STOPPED);
+	zassert_true(abs(motor_get_speed()) < 30, "speed %d", motor_get_speed());
+}